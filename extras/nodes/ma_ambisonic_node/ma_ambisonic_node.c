@@ -0,0 +1,984 @@
+#ifndef miniaudio_ambisonic_node_c
+#define miniaudio_ambisonic_node_c
+
+#include "ma_ambisonic_node.h"
+
+#include <string.h> /* For memset(). */
+#include <math.h>   /* For sqrt() and cos(). */
+
+#define MA_AMBISONIC_PI_D                   3.14159265358979323846264
+
+/* The vector helpers in miniaudio.h are not part of the public API so we have our own. */
+static ma_vec3f ma_ambisonic_vec3f(float x, float y, float z)
+{
+    ma_vec3f v;
+
+    v.x = x;
+    v.y = y;
+    v.z = z;
+
+    return v;
+}
+
+static ma_vec3f ma_ambisonic_vec3f_sub(ma_vec3f a, ma_vec3f b)
+{
+    return ma_ambisonic_vec3f(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static float ma_ambisonic_vec3f_dot(ma_vec3f a, ma_vec3f b)
+{
+    return a.x*b.x + a.y*b.y + a.z*b.z;
+}
+
+static float ma_ambisonic_vec3f_len2(ma_vec3f v)
+{
+    return ma_ambisonic_vec3f_dot(v, v);
+}
+
+static ma_vec3f ma_ambisonic_vec3f_cross(ma_vec3f a, ma_vec3f b)
+{
+    return ma_ambisonic_vec3f(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+}
+
+static ma_vec3f ma_ambisonic_vec3f_normalize(ma_vec3f v)
+{
+    float len = (float)sqrt(ma_ambisonic_vec3f_len2(v));
+    if (len == 0) {
+        return ma_ambisonic_vec3f(0, 0, 0);
+    }
+
+    return ma_ambisonic_vec3f(v.x / len, v.y / len, v.z / len);
+}
+
+/* Same as the directions used by the spatializer. Only the named positions are needed, everything else faces forward. */
+static ma_vec3f ma_ambisonic_get_channel_direction(ma_channel channel)
+{
+    switch (channel)
+    {
+        case MA_CHANNEL_FRONT_LEFT:         return ma_ambisonic_vec3f(-0.7071f,  0.0f,    -0.7071f);
+        case MA_CHANNEL_FRONT_RIGHT:        return ma_ambisonic_vec3f(+0.7071f,  0.0f,    -0.7071f);
+        case MA_CHANNEL_BACK_LEFT:          return ma_ambisonic_vec3f(-0.7071f,  0.0f,    +0.7071f);
+        case MA_CHANNEL_BACK_RIGHT:         return ma_ambisonic_vec3f(+0.7071f,  0.0f,    +0.7071f);
+        case MA_CHANNEL_FRONT_LEFT_CENTER:  return ma_ambisonic_vec3f(-0.3162f,  0.0f,    -0.9487f);
+        case MA_CHANNEL_FRONT_RIGHT_CENTER: return ma_ambisonic_vec3f(+0.3162f,  0.0f,    -0.9487f);
+        case MA_CHANNEL_BACK_CENTER:        return ma_ambisonic_vec3f( 0.0f,     0.0f,    +1.0f   );
+        case MA_CHANNEL_SIDE_LEFT:          return ma_ambisonic_vec3f(-1.0f,     0.0f,     0.0f   );
+        case MA_CHANNEL_SIDE_RIGHT:         return ma_ambisonic_vec3f(+1.0f,     0.0f,     0.0f   );
+        case MA_CHANNEL_TOP_CENTER:         return ma_ambisonic_vec3f( 0.0f,    +1.0f,     0.0f   );
+        case MA_CHANNEL_TOP_FRONT_LEFT:     return ma_ambisonic_vec3f(-0.5774f, +0.5774f, -0.5774f);
+        case MA_CHANNEL_TOP_FRONT_CENTER:   return ma_ambisonic_vec3f( 0.0f,    +0.7071f, -0.7071f);
+        case MA_CHANNEL_TOP_FRONT_RIGHT:    return ma_ambisonic_vec3f(+0.5774f, +0.5774f, -0.5774f);
+        case MA_CHANNEL_TOP_BACK_LEFT:      return ma_ambisonic_vec3f(-0.5774f, +0.5774f, +0.5774f);
+        case MA_CHANNEL_TOP_BACK_CENTER:    return ma_ambisonic_vec3f( 0.0f,    +0.7071f, +0.7071f);
+        case MA_CHANNEL_TOP_BACK_RIGHT:     return ma_ambisonic_vec3f(+0.5774f, +0.5774f, +0.5774f);
+        default:                            return ma_ambisonic_vec3f( 0.0f,     0.0f,    -1.0f   );
+    }
+}
+
+static ma_bool32 ma_ambisonic_vec3f_equal(ma_vec3f a, ma_vec3f b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+
+MA_API ma_uint32 ma_ambisonic_get_channel_count(ma_uint32 order)
+{
+    if (order < 1 || order > MA_AMBISONIC_MAX_ORDER) {
+        return 0;
+    }
+
+    return (order + 1) * (order + 1);
+}
+
+MA_API void ma_ambisonic_encode_direction(ma_uint32 order, ma_vec3f direction, float* pCoefficients)
+{
+    /*
+    The spherical harmonics are evaluated in the usual ambisonic frame where +X is forward, +Y is
+    left and +Z is up, so the direction needs to be converted from miniaudio's frame first.
+    */
+    double x, y, z;
+    double len;
+    ma_uint32 channels;
+
+    channels = ma_ambisonic_get_channel_count(order);
+    if (pCoefficients == NULL || channels == 0) {
+        return;
+    }
+
+    x = -direction.z;
+    y = -direction.x;
+    z =  direction.y;
+
+    len = sqrt(x*x + y*y + z*z);
+    if (len == 0) {
+        memset(pCoefficients, 0, channels * sizeof(float));
+        pCoefficients[0] = 1;
+        return;
+    }
+
+    x /= len;
+    y /= len;
+    z /= len;
+
+    /* ACN ordering, SN3D normalization. */
+    pCoefficients[0] = 1;
+    pCoefficients[1] = (float)y;
+    pCoefficients[2] = (float)z;
+    pCoefficients[3] = (float)x;
+
+    if (order >= 2) {
+        pCoefficients[4] = (float)(1.7320508075688772 * x * y);
+        pCoefficients[5] = (float)(1.7320508075688772 * y * z);
+        pCoefficients[6] = (float)(0.5 * (3*z*z - 1));
+        pCoefficients[7] = (float)(1.7320508075688772 * x * z);
+        pCoefficients[8] = (float)(0.8660254037844386 * (x*x - y*y));
+    }
+
+    if (order >= 3) {
+        pCoefficients[ 9] = (float)(0.7905694150420949 * y * (3*x*x - y*y));
+        pCoefficients[10] = (float)(3.8729833462074170 * x * y * z);
+        pCoefficients[11] = (float)(0.6123724356957945 * y * (5*z*z - 1));
+        pCoefficients[12] = (float)(0.5 * z * (5*z*z - 3));
+        pCoefficients[13] = (float)(0.6123724356957945 * x * (5*z*z - 1));
+        pCoefficients[14] = (float)(1.9364916731037085 * z * (x*x - y*y));
+        pCoefficients[15] = (float)(0.7905694150420949 * x * (x*x - 3*y*y));
+    }
+}
+
+
+/*
+Rotation of real spherical harmonics using the recurrence from Ivanic and Ruedenberg, "Rotation
+Matrices for Real Spherical Harmonics. Direct Determination by Recursion" (with the 1998
+corrections). Each band is derived from the previous one and the first band, which is just the
+3x3 rotation matrix with its rows and columns reordered to (y, z, x). The recurrence is defined for
+orthonormal harmonics, but since SN3D only differs by a constant factor per band the resulting
+blocks are the same.
+
+Bands are stored as (2l+1) x (2l+1) matrices indexed with [m+l][n+l].
+*/
+static double ma_ambisonic_rotation_p(int i, int l, int a, int b, double R1[3][3], const double* pPrev)
+{
+    int prevSize = 2*l - 1;
+    double ri1  = R1[i+1][2];
+    double rim1 = R1[i+1][0];
+    double ri0  = R1[i+1][1];
+
+    if (b == -l) {
+        return ri1 * pPrev[(a+l-1)*prevSize + 0] + rim1 * pPrev[(a+l-1)*prevSize + (2*l-2)];
+    } else if (b == l) {
+        return ri1 * pPrev[(a+l-1)*prevSize + (2*l-2)] - rim1 * pPrev[(a+l-1)*prevSize + 0];
+    } else {
+        return ri0 * pPrev[(a+l-1)*prevSize + (b+l-1)];
+    }
+}
+
+static double ma_ambisonic_rotation_v(int l, int m, int n, double R1[3][3], const double* pPrev)
+{
+    if (m == 0) {
+        return ma_ambisonic_rotation_p(1, l, 1, n, R1, pPrev) + ma_ambisonic_rotation_p(-1, l, -1, n, R1, pPrev);
+    } else if (m > 0) {
+        double d = (m == 1) ? 1 : 0;
+        return ma_ambisonic_rotation_p(1, l, m-1, n, R1, pPrev) * sqrt(1+d) - ma_ambisonic_rotation_p(-1, l, -m+1, n, R1, pPrev) * (1-d);
+    } else {
+        double d = (m == -1) ? 1 : 0;
+        return ma_ambisonic_rotation_p(1, l, m+1, n, R1, pPrev) * (1-d) + ma_ambisonic_rotation_p(-1, l, -m-1, n, R1, pPrev) * sqrt(1+d);
+    }
+}
+
+static double ma_ambisonic_rotation_w(int l, int m, int n, double R1[3][3], const double* pPrev)
+{
+    /* Never called with m == 0. */
+    if (m > 0) {
+        return ma_ambisonic_rotation_p(1, l, m+1, n, R1, pPrev) + ma_ambisonic_rotation_p(-1, l, -m-1, n, R1, pPrev);
+    } else {
+        return ma_ambisonic_rotation_p(1, l, m-1, n, R1, pPrev) - ma_ambisonic_rotation_p(-1, l, -m+1, n, R1, pPrev);
+    }
+}
+
+static void ma_ambisonic_rotation_from_matrix(ma_uint32 order, double R[3][3], float* pMatrix)
+{
+    double R1[3][3];
+    double bands[2][(2*MA_AMBISONIC_MAX_ORDER+1)*(2*MA_AMBISONIC_MAX_ORDER+1)];
+    ma_uint32 channels = ma_ambisonic_get_channel_count(order);
+    int l;
+    int m;
+    int n;
+    int i;
+    int j;
+
+    memset(pMatrix, 0, channels*channels * sizeof(float));
+    pMatrix[0] = 1;
+
+    /* Band 1. Real harmonic order within the band is (y, z, x). */
+    R1[0][0] = R[1][1]; R1[0][1] = R[1][2]; R1[0][2] = R[1][0];
+    R1[1][0] = R[2][1]; R1[1][1] = R[2][2]; R1[1][2] = R[2][0];
+    R1[2][0] = R[0][1]; R1[2][1] = R[0][2]; R1[2][2] = R[0][0];
+
+    for (i = 0; i < 3; i += 1) {
+        for (j = 0; j < 3; j += 1) {
+            bands[1][i*3 + j] = R1[i][j];
+            pMatrix[(1+i)*channels + (1+j)] = (float)R1[i][j];
+        }
+    }
+
+    for (l = 2; l <= (int)order; l += 1) {
+        const double* pPrev = bands[(l-1) & 1];
+        double* pCurr = bands[l & 1];
+        int size = 2*l + 1;
+        int base = l*l;
+
+        for (m = -l; m <= l; m += 1) {
+            for (n = -l; n <= l; n += 1) {
+                int absM = (m < 0) ? -m : m;
+                double d = (m == 0) ? 1 : 0;
+                double denom = (n == -l || n == l) ? (double)((2*l)*(2*l-1)) : (double)(l*l - n*n);
+                double u = sqrt((l*l - m*m) / denom);
+                double v = sqrt((1+d) * (l+absM-1) * (l+absM) / denom) * (1-2*d) * 0.5;
+                double w = sqrt((l-absM-1) * (l-absM) / denom) * (1-d) * -0.5;
+                double r = 0;
+
+                if (u != 0) {
+                    r += u * ma_ambisonic_rotation_p(0, l, m, n, R1, pPrev);
+                }
+                if (v != 0) {
+                    r += v * ma_ambisonic_rotation_v(l, m, n, R1, pPrev);
+                }
+                if (w != 0) {
+                    r += w * ma_ambisonic_rotation_w(l, m, n, R1, pPrev);
+                }
+
+                pCurr[(m+l)*size + (n+l)] = r;
+                pMatrix[(base+m+l)*channels + (base+n+l)] = (float)r;
+            }
+        }
+    }
+}
+
+MA_API void ma_ambisonic_get_rotation_matrix(ma_uint32 order, ma_vec3f forward, ma_vec3f up, float* pMatrix)
+{
+    /*
+    The world space axes of the ambisonic frame expressed in miniaudio's frame. These are projected
+    onto the listener's forward, left and up vectors to get the 3x3 rotation from world space to
+    listener space.
+    */
+    static const float axes[3][3] = {
+        { 0,  0, -1},   /* Forward. */
+        {-1,  0,  0},   /* Left. */
+        { 0,  1,  0}    /* Up. */
+    };
+    double R[3][3];
+    ma_vec3f f;
+    ma_vec3f r;
+    ma_vec3f u;
+    int j;
+
+    if (pMatrix == NULL || ma_ambisonic_get_channel_count(order) == 0) {
+        return;
+    }
+
+    f = ma_ambisonic_vec3f_normalize(forward);
+    r = ma_ambisonic_vec3f_normalize(ma_ambisonic_vec3f_cross(f, up));
+    if (ma_ambisonic_vec3f_len2(f) == 0 || ma_ambisonic_vec3f_len2(r) == 0) {
+        /* Degenerate orientation. Fall back to the identity. */
+        f = ma_ambisonic_vec3f(0, 0, -1);
+        r = ma_ambisonic_vec3f(1, 0,  0);
+    }
+    u = ma_ambisonic_vec3f_cross(r, f);
+
+    for (j = 0; j < 3; j += 1) {
+        ma_vec3f axis = ma_ambisonic_vec3f(axes[j][0], axes[j][1], axes[j][2]);
+        R[0][j] =  ma_ambisonic_vec3f_dot(axis, f);
+        R[1][j] = -ma_ambisonic_vec3f_dot(axis, r);
+        R[2][j] =  ma_ambisonic_vec3f_dot(axis, u);
+    }
+
+    ma_ambisonic_rotation_from_matrix(order, R, pMatrix);
+}
+
+
+/*
+Builds a sampling decoder to the given directions. With SN3D the projection onto each direction
+needs a (2l+1) factor per band to come out the same as it would with orthonormal harmonics. The
+result is normalized so that a plane wave has unit energy on average over the sphere, which keeps
+the loudness consistent between layouts.
+*/
+static void ma_ambisonic_build_sampling_decoder(ma_uint32 order, ma_ambisonic_weighting weighting, const ma_vec3f* pDirections, ma_uint32 directionCount, float* pMatrix)
+{
+    float bandGains[MA_AMBISONIC_MAX_ORDER + 1];
+    float coefficients[MA_AMBISONIC_MAX_CHANNELS];
+    ma_uint32 channels = ma_ambisonic_get_channel_count(order);
+    ma_uint32 iDirection;
+    ma_uint32 iChannel;
+    ma_uint32 iPoint;
+    ma_uint32 l;
+    double energy;
+    float scale;
+    const ma_uint32 pointCount = 256;
+
+    for (l = 0; l <= order; l += 1) {
+        bandGains[l] = (float)(2*l + 1);
+    }
+
+    if (weighting == ma_ambisonic_weighting_max_re) {
+        /* Legendre polynomials evaluated at the largest root of P(order+1), approximated as cos(137.9 degrees / (order + 1.51)). */
+        double x = cos((137.9 / (order + 1.51)) * (MA_AMBISONIC_PI_D / 180));
+        double p[4];
+        p[0] = 1;
+        p[1] = x;
+        p[2] = 0.5 * (3*x*x - 1);
+        p[3] = 0.5 * (5*x*x*x - 3*x);
+
+        for (l = 0; l <= order; l += 1) {
+            bandGains[l] *= (float)p[l];
+        }
+    }
+
+    for (iDirection = 0; iDirection < directionCount; iDirection += 1) {
+        ma_ambisonic_encode_direction(order, pDirections[iDirection], coefficients);
+
+        for (l = 0; l <= order; l += 1) {
+            for (iChannel = l*l; iChannel < (l+1)*(l+1); iChannel += 1) {
+                pMatrix[iDirection*channels + iChannel] = coefficients[iChannel] * bandGains[l] / directionCount;
+            }
+        }
+    }
+
+    /* Average energy over a Fibonacci sphere. */
+    energy = 0;
+    for (iPoint = 0; iPoint < pointCount; iPoint += 1) {
+        double py  = 1 - (2.0*iPoint + 1) / pointCount;
+        double rad = sqrt(1 - py*py);
+        double phi = iPoint * 2.399963229728653;   /* Golden angle. */
+
+        ma_ambisonic_encode_direction(order, ma_ambisonic_vec3f((float)(rad*cos(phi)), (float)py, (float)(rad*sin(phi))), coefficients);
+
+        for (iDirection = 0; iDirection < directionCount; iDirection += 1) {
+            double gain = 0;
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                gain += pMatrix[iDirection*channels + iChannel] * coefficients[iChannel];
+            }
+
+            energy += gain*gain;
+        }
+    }
+
+    energy /= pointCount;
+    if (energy <= 0) {
+        return;
+    }
+
+    scale = (float)(1 / sqrt(energy));
+    for (iChannel = 0; iChannel < directionCount*channels; iChannel += 1) {
+        pMatrix[iChannel] *= scale;
+    }
+}
+
+
+
+MA_API ma_ambisonic_encoder_node_config ma_ambisonic_encoder_node_config_init(ma_uint32 order)
+{
+    ma_ambisonic_encoder_node_config config;
+
+    memset(&config, 0, sizeof(config));
+    config.nodeConfig = ma_node_config_init();  /* Input and output channels will be set in ma_ambisonic_encoder_node_init(). */
+    config.order      = order;
+    config.direction  = ma_ambisonic_vec3f(0, 0, -1);
+
+    return config;
+}
+
+
+static void ma_ambisonic_encoder_node_process_pcm_frames(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    ma_ambisonic_encoder_node* pEncoderNode = (ma_ambisonic_encoder_node*)pNode;
+    const float* pFramesIn  = ppFramesIn[0];
+    float* pFramesOut = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channels = pEncoderNode->channels;
+    float target[MA_AMBISONIC_MAX_CHANNELS];
+    ma_uint32 iFrame;
+    ma_uint32 iChannel;
+
+    (void)pFrameCountIn;
+
+    ma_spinlock_lock(&pEncoderNode->lock);
+    {
+        memcpy(target, pEncoderNode->targetCoefficients, sizeof(target));
+    }
+    ma_spinlock_unlock(&pEncoderNode->lock);
+
+    if (memcmp(target, pEncoderNode->coefficients, channels * sizeof(float)) == 0) {
+        for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+            float x = pFramesIn[iFrame];
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                pFramesOut[iFrame*channels + iChannel] = x * target[iChannel];
+            }
+        }
+    } else {
+        /* The direction has changed. Ramp the coefficients across the block. */
+        float delta[MA_AMBISONIC_MAX_CHANNELS];
+        float step = (frameCount > 0) ? 1.0f / frameCount : 0;
+
+        for (iChannel = 0; iChannel < channels; iChannel += 1) {
+            delta[iChannel] = target[iChannel] - pEncoderNode->coefficients[iChannel];
+        }
+
+        for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+            float x = pFramesIn[iFrame];
+            float t = (iFrame + 1) * step;
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                pFramesOut[iFrame*channels + iChannel] = x * (pEncoderNode->coefficients[iChannel] + delta[iChannel]*t);
+            }
+        }
+
+        memcpy(pEncoderNode->coefficients, target, channels * sizeof(float));
+    }
+}
+
+static ma_node_vtable g_ma_ambisonic_encoder_node_vtable =
+{
+    ma_ambisonic_encoder_node_process_pcm_frames,
+    NULL,
+    1,  /* 1 input bus. */
+    1,  /* 1 output bus. */
+    0
+};
+
+MA_API ma_result ma_ambisonic_encoder_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_encoder_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_encoder_node* pEncoderNode)
+{
+    ma_result result;
+    ma_node_config baseConfig;
+    ma_uint32 inputChannels[1];
+    ma_uint32 outputChannels[1];
+
+    if (pEncoderNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    memset(pEncoderNode, 0, sizeof(*pEncoderNode));
+
+    if (pConfig == NULL || ma_ambisonic_get_channel_count(pConfig->order) == 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    pEncoderNode->order     = pConfig->order;
+    pEncoderNode->channels  = ma_ambisonic_get_channel_count(pConfig->order);
+    pEncoderNode->direction = pConfig->direction;
+    ma_ambisonic_encode_direction(pEncoderNode->order, pEncoderNode->direction, pEncoderNode->targetCoefficients);
+    memcpy(pEncoderNode->coefficients, pEncoderNode->targetCoefficients, sizeof(pEncoderNode->coefficients));
+
+    inputChannels [0] = 1;
+    outputChannels[0] = pEncoderNode->channels;
+
+    baseConfig = pConfig->nodeConfig;
+    baseConfig.vtable          = &g_ma_ambisonic_encoder_node_vtable;
+    baseConfig.pInputChannels  = inputChannels;
+    baseConfig.pOutputChannels = outputChannels;
+
+    result = ma_node_init(pNodeGraph, &baseConfig, pAllocationCallbacks, &pEncoderNode->baseNode);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    return MA_SUCCESS;
+}
+
+MA_API void ma_ambisonic_encoder_node_uninit(ma_ambisonic_encoder_node* pEncoderNode, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    /* The base node is always uninitialized first. */
+    ma_node_uninit(pEncoderNode, pAllocationCallbacks);
+}
+
+MA_API void ma_ambisonic_encoder_node_set_direction(ma_ambisonic_encoder_node* pEncoderNode, float x, float y, float z)
+{
+    float coefficients[MA_AMBISONIC_MAX_CHANNELS];
+    ma_vec3f direction;
+
+    if (pEncoderNode == NULL) {
+        return;
+    }
+
+    direction = ma_ambisonic_vec3f(x, y, z);
+    ma_ambisonic_encode_direction(pEncoderNode->order, direction, coefficients);
+
+    ma_spinlock_lock(&pEncoderNode->lock);
+    {
+        pEncoderNode->direction = direction;
+        memcpy(pEncoderNode->targetCoefficients, coefficients, pEncoderNode->channels * sizeof(float));
+    }
+    ma_spinlock_unlock(&pEncoderNode->lock);
+}
+
+MA_API ma_vec3f ma_ambisonic_encoder_node_get_direction(const ma_ambisonic_encoder_node* pEncoderNode)
+{
+    ma_vec3f direction;
+
+    if (pEncoderNode == NULL) {
+        return ma_ambisonic_vec3f(0, 0, -1);
+    }
+
+    ma_spinlock_lock((volatile ma_spinlock*)&pEncoderNode->lock);
+    {
+        direction = pEncoderNode->direction;
+    }
+    ma_spinlock_unlock((volatile ma_spinlock*)&pEncoderNode->lock);
+
+    return direction;
+}
+
+MA_API void ma_ambisonic_encoder_node_set_position(ma_ambisonic_encoder_node* pEncoderNode, const ma_spatializer_listener* pListener, float x, float y, float z)
+{
+    ma_vec3f relative = ma_ambisonic_vec3f(x, y, z);
+
+    if (pListener != NULL) {
+        relative = ma_ambisonic_vec3f_sub(relative, ma_spatializer_listener_get_position(pListener));
+    }
+
+    ma_ambisonic_encoder_node_set_direction(pEncoderNode, relative.x, relative.y, relative.z);
+}
+
+
+
+MA_API ma_ambisonic_rotator_node_config ma_ambisonic_rotator_node_config_init(ma_uint32 order, const ma_spatializer_listener* pListener)
+{
+    ma_ambisonic_rotator_node_config config;
+
+    memset(&config, 0, sizeof(config));
+    config.nodeConfig = ma_node_config_init();  /* Input and output channels will be set in ma_ambisonic_rotator_node_init(). */
+    config.order      = order;
+    config.pListener  = pListener;
+
+    return config;
+}
+
+
+static void ma_ambisonic_rotate_frame(ma_uint32 order, ma_uint32 channels, const float* pMatrix, const float* pFrameIn, float* pFrameOut)
+{
+    ma_uint32 l;
+    ma_uint32 i;
+    ma_uint32 j;
+
+    pFrameOut[0] = pFrameIn[0];
+
+    /* Only the blocks on the diagonal are non-zero. */
+    for (l = 1; l <= order; l += 1) {
+        ma_uint32 lo = l*l;
+        ma_uint32 hi = (l+1)*(l+1);
+
+        for (i = lo; i < hi; i += 1) {
+            float r = 0;
+            for (j = lo; j < hi; j += 1) {
+                r += pMatrix[i*channels + j] * pFrameIn[j];
+            }
+
+            pFrameOut[i] = r;
+        }
+    }
+}
+
+static void ma_ambisonic_rotator_node_process_pcm_frames(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    ma_ambisonic_rotator_node* pRotatorNode = (ma_ambisonic_rotator_node*)pNode;
+    const float* pFramesIn  = ppFramesIn[0];
+    float* pFramesOut = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channels = pRotatorNode->channels;
+    ma_uint32 order = pRotatorNode->order;
+    ma_vec3f forward;
+    ma_vec3f up;
+    ma_uint32 iFrame;
+    ma_uint32 iChannel;
+
+    (void)pFrameCountIn;
+
+    if (pRotatorNode->pListener != NULL) {
+        forward = ma_spatializer_listener_get_direction(pRotatorNode->pListener);
+        up      = ma_spatializer_listener_get_world_up(pRotatorNode->pListener);
+    } else {
+        ma_spinlock_lock(&pRotatorNode->lock);
+        {
+            forward = pRotatorNode->forward;
+            up      = pRotatorNode->up;
+        }
+        ma_spinlock_unlock(&pRotatorNode->lock);
+    }
+
+    if (ma_ambisonic_vec3f_equal(forward, pRotatorNode->appliedForward) && ma_ambisonic_vec3f_equal(up, pRotatorNode->appliedUp)) {
+        for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+            ma_ambisonic_rotate_frame(order, channels, pRotatorNode->matrix, pFramesIn + iFrame*channels, pFramesOut + iFrame*channels);
+        }
+    } else {
+        /* The orientation has changed. Crossfade from the old rotation to the new one. */
+        float step = (frameCount > 0) ? 1.0f / frameCount : 0;
+
+        ma_ambisonic_get_rotation_matrix(order, forward, up, pRotatorNode->targetMatrix);
+
+        for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+            float frameOld[MA_AMBISONIC_MAX_CHANNELS];
+            float frameNew[MA_AMBISONIC_MAX_CHANNELS];
+            float t = (iFrame + 1) * step;
+
+            ma_ambisonic_rotate_frame(order, channels, pRotatorNode->matrix,       pFramesIn + iFrame*channels, frameOld);
+            ma_ambisonic_rotate_frame(order, channels, pRotatorNode->targetMatrix, pFramesIn + iFrame*channels, frameNew);
+
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                pFramesOut[iFrame*channels + iChannel] = frameOld[iChannel] + (frameNew[iChannel] - frameOld[iChannel])*t;
+            }
+        }
+
+        memcpy(pRotatorNode->matrix, pRotatorNode->targetMatrix, sizeof(pRotatorNode->matrix));
+        pRotatorNode->appliedForward = forward;
+        pRotatorNode->appliedUp      = up;
+    }
+}
+
+static ma_node_vtable g_ma_ambisonic_rotator_node_vtable =
+{
+    ma_ambisonic_rotator_node_process_pcm_frames,
+    NULL,
+    1,  /* 1 input bus. */
+    1,  /* 1 output bus. */
+    0
+};
+
+MA_API ma_result ma_ambisonic_rotator_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_rotator_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_rotator_node* pRotatorNode)
+{
+    ma_result result;
+    ma_node_config baseConfig;
+    ma_uint32 channels;
+
+    if (pRotatorNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    memset(pRotatorNode, 0, sizeof(*pRotatorNode));
+
+    if (pConfig == NULL || ma_ambisonic_get_channel_count(pConfig->order) == 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    channels = ma_ambisonic_get_channel_count(pConfig->order);
+
+    pRotatorNode->order          = pConfig->order;
+    pRotatorNode->channels       = channels;
+    pRotatorNode->pListener      = pConfig->pListener;
+    pRotatorNode->forward        = ma_ambisonic_vec3f(0, 0, -1);
+    pRotatorNode->up             = ma_ambisonic_vec3f(0, 1,  0);
+    pRotatorNode->appliedForward = pRotatorNode->forward;
+    pRotatorNode->appliedUp      = pRotatorNode->up;
+    ma_ambisonic_get_rotation_matrix(pRotatorNode->order, pRotatorNode->forward, pRotatorNode->up, pRotatorNode->matrix);
+
+    baseConfig = pConfig->nodeConfig;
+    baseConfig.vtable          = &g_ma_ambisonic_rotator_node_vtable;
+    baseConfig.pInputChannels  = &channels;
+    baseConfig.pOutputChannels = &channels;
+
+    result = ma_node_init(pNodeGraph, &baseConfig, pAllocationCallbacks, &pRotatorNode->baseNode);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    return MA_SUCCESS;
+}
+
+MA_API void ma_ambisonic_rotator_node_uninit(ma_ambisonic_rotator_node* pRotatorNode, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    /* The base node is always uninitialized first. */
+    ma_node_uninit(pRotatorNode, pAllocationCallbacks);
+}
+
+MA_API void ma_ambisonic_rotator_node_set_orientation(ma_ambisonic_rotator_node* pRotatorNode, ma_vec3f forward, ma_vec3f up)
+{
+    if (pRotatorNode == NULL) {
+        return;
+    }
+
+    ma_spinlock_lock(&pRotatorNode->lock);
+    {
+        pRotatorNode->forward = forward;
+        pRotatorNode->up      = up;
+    }
+    ma_spinlock_unlock(&pRotatorNode->lock);
+}
+
+
+
+MA_API ma_ambisonic_decoder_node_config ma_ambisonic_decoder_node_config_init(ma_uint32 order, ma_uint32 channelsOut)
+{
+    ma_ambisonic_decoder_node_config config;
+
+    memset(&config, 0, sizeof(config));
+    config.nodeConfig  = ma_node_config_init();  /* Input and output channels will be set in ma_ambisonic_decoder_node_init(). */
+    config.order       = order;
+    config.channelsOut = channelsOut;
+    config.weighting   = ma_ambisonic_weighting_max_re;
+
+    return config;
+}
+
+
+static void ma_ambisonic_decoder_node_process_pcm_frames(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    ma_ambisonic_decoder_node* pDecoderNode = (ma_ambisonic_decoder_node*)pNode;
+    const float* pFramesIn  = ppFramesIn[0];
+    float* pFramesOut = ppFramesOut[0];
+    ma_uint32 frameCount  = *pFrameCountOut;
+    ma_uint32 channelsIn  = pDecoderNode->channelsIn;
+    ma_uint32 channelsOut = pDecoderNode->channelsOut;
+    ma_uint32 iFrame;
+    ma_uint32 iChannelIn;
+    ma_uint32 iChannelOut;
+
+    (void)pFrameCountIn;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        for (iChannelOut = 0; iChannelOut < channelsOut; iChannelOut += 1) {
+            const float* pRow = pDecoderNode->pMatrix + iChannelOut*channelsIn;
+            float r = 0;
+
+            for (iChannelIn = 0; iChannelIn < channelsIn; iChannelIn += 1) {
+                r += pRow[iChannelIn] * pFramesIn[iChannelIn];
+            }
+
+            pFramesOut[iChannelOut] = r;
+        }
+
+        pFramesIn  += channelsIn;
+        pFramesOut += channelsOut;
+    }
+}
+
+static ma_node_vtable g_ma_ambisonic_decoder_node_vtable =
+{
+    ma_ambisonic_decoder_node_process_pcm_frames,
+    NULL,
+    1,  /* 1 input bus. */
+    1,  /* 1 output bus. */
+    0
+};
+
+MA_API ma_result ma_ambisonic_decoder_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_decoder_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_decoder_node* pDecoderNode)
+{
+    ma_result result;
+    ma_node_config baseConfig;
+    ma_uint32 channelsIn;
+    ma_uint32 channelsOut;
+    ma_uint32 iChannelOut;
+
+    if (pDecoderNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    memset(pDecoderNode, 0, sizeof(*pDecoderNode));
+
+    if (pConfig == NULL || ma_ambisonic_get_channel_count(pConfig->order) == 0 || pConfig->channelsOut == 0 || pConfig->channelsOut > MA_MAX_CHANNELS) {
+        return MA_INVALID_ARGS;
+    }
+
+    channelsIn  = ma_ambisonic_get_channel_count(pConfig->order);
+    channelsOut = pConfig->channelsOut;
+
+    pDecoderNode->order       = pConfig->order;
+    pDecoderNode->channelsIn  = channelsIn;
+    pDecoderNode->channelsOut = channelsOut;
+    pDecoderNode->pMatrix     = (float*)ma_malloc(channelsOut*channelsIn * sizeof(float), pAllocationCallbacks);
+    if (pDecoderNode->pMatrix == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    if (pConfig->pDecodeMatrix != NULL) {
+        memcpy(pDecoderNode->pMatrix, pConfig->pDecodeMatrix, channelsOut*channelsIn * sizeof(float));
+    } else if (pConfig->pSpeakerDirections != NULL) {
+        ma_ambisonic_build_sampling_decoder(pDecoderNode->order, pConfig->weighting, pConfig->pSpeakerDirections, channelsOut, pDecoderNode->pMatrix);
+    } else {
+        /* Directions come from the channel map. LFE channels get a zero row and are excluded from the layout. */
+        ma_vec3f directions[MA_MAX_CHANNELS];
+        ma_uint32 speakerCount = 0;
+
+        for (iChannelOut = 0; iChannelOut < channelsOut; iChannelOut += 1) {
+            ma_channel channel = ma_channel_map_get_channel(pConfig->pChannelMapOut, channelsOut, iChannelOut);
+            if (channel != MA_CHANNEL_LFE) {
+                directions[speakerCount] = ma_ambisonic_get_channel_direction(channel);
+                speakerCount += 1;
+            }
+        }
+
+        memset(pDecoderNode->pMatrix, 0, channelsOut*channelsIn * sizeof(float));
+
+        if (speakerCount > 0) {
+            float* pSpeakerMatrix = (float*)ma_malloc(speakerCount*channelsIn * sizeof(float), pAllocationCallbacks);
+            ma_uint32 iSpeaker = 0;
+
+            if (pSpeakerMatrix == NULL) {
+                ma_free(pDecoderNode->pMatrix, pAllocationCallbacks);
+                return MA_OUT_OF_MEMORY;
+            }
+
+            ma_ambisonic_build_sampling_decoder(pDecoderNode->order, pConfig->weighting, directions, speakerCount, pSpeakerMatrix);
+
+            for (iChannelOut = 0; iChannelOut < channelsOut; iChannelOut += 1) {
+                if (ma_channel_map_get_channel(pConfig->pChannelMapOut, channelsOut, iChannelOut) != MA_CHANNEL_LFE) {
+                    memcpy(pDecoderNode->pMatrix + iChannelOut*channelsIn, pSpeakerMatrix + iSpeaker*channelsIn, channelsIn * sizeof(float));
+                    iSpeaker += 1;
+                }
+            }
+
+            ma_free(pSpeakerMatrix, pAllocationCallbacks);
+        }
+    }
+
+    baseConfig = pConfig->nodeConfig;
+    baseConfig.vtable          = &g_ma_ambisonic_decoder_node_vtable;
+    baseConfig.pInputChannels  = &channelsIn;
+    baseConfig.pOutputChannels = &channelsOut;
+
+    result = ma_node_init(pNodeGraph, &baseConfig, pAllocationCallbacks, &pDecoderNode->baseNode);
+    if (result != MA_SUCCESS) {
+        ma_free(pDecoderNode->pMatrix, pAllocationCallbacks);
+        return result;
+    }
+
+    return MA_SUCCESS;
+}
+
+MA_API void ma_ambisonic_decoder_node_uninit(ma_ambisonic_decoder_node* pDecoderNode, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pDecoderNode == NULL) {
+        return;
+    }
+
+    /* The base node is always uninitialized first. */
+    ma_node_uninit(pDecoderNode, pAllocationCallbacks);
+    ma_free(pDecoderNode->pMatrix, pAllocationCallbacks);
+}
+
+
+
+MA_API ma_ambisonic_binaural_node_config ma_ambisonic_binaural_node_config_init(ma_uint32 order, const float* pImpulseResponses, ma_uint32 impulseResponseLengthInFrames)
+{
+    ma_ambisonic_binaural_node_config config;
+
+    memset(&config, 0, sizeof(config));
+    config.nodeConfig = ma_node_config_init();  /* Input and output channels will be set in ma_ambisonic_binaural_node_init(). */
+    config.order      = order;
+    config.pImpulseResponses = pImpulseResponses;
+    config.impulseResponseLengthInFrames = impulseResponseLengthInFrames;
+    config.weighting  = ma_ambisonic_weighting_max_re;
+    config.partitionSizeInFrames = 128;
+
+    return config;
+}
+
+MA_API ma_result ma_ambisonic_binaural_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_binaural_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_binaural_node* pBinauralNode)
+{
+    ma_result result;
+    ma_convolution_node_config convolutionNodeConfig;
+    ma_uint32 channels;
+    ma_uint32 filterCount;
+    ma_uint32 length;
+    float* pFilters;
+    ma_uint32 iChannel;
+    ma_uint32 iEar;
+    ma_uint32 iTap;
+
+    if (pBinauralNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    memset(pBinauralNode, 0, sizeof(*pBinauralNode));
+
+    if (pConfig == NULL || ma_ambisonic_get_channel_count(pConfig->order) == 0 || pConfig->pImpulseResponses == NULL || pConfig->impulseResponseLengthInFrames == 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    if (pConfig->pImpulseResponseDirections != NULL && pConfig->impulseResponseDirectionCount == 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    channels    = ma_ambisonic_get_channel_count(pConfig->order);
+    filterCount = channels * 2;
+    length      = pConfig->impulseResponseLengthInFrames;
+
+    /*
+    The convolution node wants an interleaved matrix of filters where the filter for ambisonic channel c and ear e is
+    channel c*2 + e. This is only needed during initialization because the convolution node takes a copy.
+    */
+    pFilters = (float*)ma_malloc((size_t)filterCount * length * sizeof(float), pAllocationCallbacks);
+    if (pFilters == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    if (pConfig->pImpulseResponseDirections == NULL) {
+        for (iChannel = 0; iChannel < channels; iChannel += 1) {
+            for (iEar = 0; iEar < 2; iEar += 1) {
+                const float* pResponse = pConfig->pImpulseResponses + (iChannel*2 + iEar)*length;
+
+                for (iTap = 0; iTap < length; iTap += 1) {
+                    pFilters[iTap*filterCount + iChannel*2 + iEar] = pResponse[iTap];
+                }
+            }
+        }
+    } else {
+        /*
+        Decode to the virtual speakers and fold each speaker's impulse responses into the
+        per-channel filters. The filter for a channel is the sum of every speaker's response
+        weighted by that speaker's decoding gain for the channel.
+        */
+        ma_uint32 directionCount = pConfig->impulseResponseDirectionCount;
+        ma_uint32 iDirection;
+        float* pDecodeMatrix;
+
+        pDecodeMatrix = (float*)ma_malloc(directionCount*channels * sizeof(float), pAllocationCallbacks);
+        if (pDecodeMatrix == NULL) {
+            ma_free(pFilters, pAllocationCallbacks);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        ma_ambisonic_build_sampling_decoder(pConfig->order, pConfig->weighting, pConfig->pImpulseResponseDirections, directionCount, pDecodeMatrix);
+
+        memset(pFilters, 0, (size_t)filterCount * length * sizeof(float));
+
+        for (iDirection = 0; iDirection < directionCount; iDirection += 1) {
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                float gain = pDecodeMatrix[iDirection*channels + iChannel];
+
+                for (iEar = 0; iEar < 2; iEar += 1) {
+                    const float* pResponse = pConfig->pImpulseResponses + (iDirection*2 + iEar)*length;
+
+                    for (iTap = 0; iTap < length; iTap += 1) {
+                        pFilters[iTap*filterCount + iChannel*2 + iEar] += gain * pResponse[iTap];
+                    }
+                }
+            }
+        }
+
+        ma_free(pDecodeMatrix, pAllocationCallbacks);
+    }
+
+    convolutionNodeConfig = ma_convolution_node_config_init(channels, 2, pFilters, filterCount, length);
+    convolutionNodeConfig.nodeConfig            = pConfig->nodeConfig;
+    convolutionNodeConfig.partitionSizeInFrames = pConfig->partitionSizeInFrames;
+
+    result = ma_convolution_node_init(pNodeGraph, &convolutionNodeConfig, pAllocationCallbacks, &pBinauralNode->convolutionNode);
+    ma_free(pFilters, pAllocationCallbacks);
+
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    pBinauralNode->order    = pConfig->order;
+    pBinauralNode->channels = channels;
+
+    return MA_SUCCESS;
+}
+
+MA_API void ma_ambisonic_binaural_node_uninit(ma_ambisonic_binaural_node* pBinauralNode, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pBinauralNode == NULL) {
+        return;
+    }
+
+    ma_convolution_node_uninit(&pBinauralNode->convolutionNode, pAllocationCallbacks);
+}
+
+#endif  /* miniaudio_ambisonic_node_c */
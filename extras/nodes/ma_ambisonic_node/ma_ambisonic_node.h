@@ -0,0 +1,226 @@
+/* Include ma_ambisonic_node.h after miniaudio.h */
+#ifndef miniaudio_ambisonic_node_h
+#define miniaudio_ambisonic_node_h
+
+#include "../../../miniaudio.h"
+#include "../ma_convolution_node/ma_convolution_node.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+Higher order ambisonics (HOA) nodes. A scene is built in three stages:
+
+    encoder(s) -> rotator -> decoder
+
+Each encoder takes a mono input and outputs an ambisonic stream of the given order. Any number of
+encoders can be attached to the same rotator (or decoder) input bus in which case they'll be mixed
+by the node graph like any other node. The rotator applies the listener's orientation to the whole
+scene in one go, which means per-source cost is just the encode and doesn't depend on the number
+of output speakers. The decoder then renders the rotated scene to either a speaker layout
+(`ma_ambisonic_decoder_node`) or to headphones via user supplied impulse responses
+(`ma_ambisonic_binaural_node`).
+
+Orders 1 to 3 are supported, which is 4, 9 or 16 channels. Channels are ordered with ACN and use
+SN3D normalization (the AmbiX convention). Directions are always specified in miniaudio's
+coordinate system, the same one used by the spatializer: +X is right, +Y is up and -Z is forward.
+
+To feed a sound into an encoder, initialize it with `channelsOut` set to 1 and spatialization
+disabled, then attach it to input bus 0 of the encoder.
+*/
+#define MA_AMBISONIC_MAX_ORDER      3
+#define MA_AMBISONIC_MAX_CHANNELS   16  /* (MA_AMBISONIC_MAX_ORDER + 1)^2 */
+
+typedef enum
+{
+    ma_ambisonic_weighting_basic,   /* Plain sampling decoder. Sharpest localization directly at the speakers. */
+    ma_ambisonic_weighting_max_re   /* Max-rE weighting. Reduces side lobes and gives a more even image between speakers. This is the default. */
+} ma_ambisonic_weighting;
+
+/* Retrieves the number of channels of an ambisonic stream of the given order. Returns 0 if the order is not supported. */
+MA_API ma_uint32 ma_ambisonic_get_channel_count(ma_uint32 order);
+
+/*
+Calculates the encoding coefficients of a plane wave coming from the given direction. `pCoefficients`
+must have room for `ma_ambisonic_get_channel_count(order)` values. The direction does not need to be
+normalized. A zero length direction results in an omnidirectional encoding.
+*/
+MA_API void ma_ambisonic_encode_direction(ma_uint32 order, ma_vec3f direction, float* pCoefficients);
+
+/*
+Calculates the matrix that rotates a world space scene into the frame of a listener with the given
+forward and up vectors. The matrix is square with `ma_ambisonic_get_channel_count(order)` rows and
+is stored in row-major order. It's block diagonal, so only coefficients within the same order are
+mixed together.
+*/
+MA_API void ma_ambisonic_get_rotation_matrix(ma_uint32 order, ma_vec3f forward, ma_vec3f up, float* pMatrix);
+
+
+
+/*
+The encoder node has one mono input and one output with `ma_ambisonic_get_channel_count(order)`
+channels. Changes to the direction are smoothed over the next processed block.
+*/
+typedef struct
+{
+    ma_node_config nodeConfig;
+    ma_uint32 order;
+    ma_vec3f direction;         /* The initial direction of the source, relative to the listener's position but in world space. Defaults to (0, 0, -1). */
+} ma_ambisonic_encoder_node_config;
+
+MA_API ma_ambisonic_encoder_node_config ma_ambisonic_encoder_node_config_init(ma_uint32 order);
+
+
+typedef struct
+{
+    ma_node_base baseNode;
+    ma_uint32 order;
+    ma_uint32 channels;
+    ma_spinlock lock;
+    ma_vec3f direction;
+    float targetCoefficients[MA_AMBISONIC_MAX_CHANNELS];    /* Protected by the lock. */
+    float coefficients[MA_AMBISONIC_MAX_CHANNELS];          /* Only accessed from the audio thread. */
+} ma_ambisonic_encoder_node;
+
+MA_API ma_result ma_ambisonic_encoder_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_encoder_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_encoder_node* pEncoderNode);
+MA_API void ma_ambisonic_encoder_node_uninit(ma_ambisonic_encoder_node* pEncoderNode, const ma_allocation_callbacks* pAllocationCallbacks);
+MA_API void ma_ambisonic_encoder_node_set_direction(ma_ambisonic_encoder_node* pEncoderNode, float x, float y, float z);
+MA_API ma_vec3f ma_ambisonic_encoder_node_get_direction(const ma_ambisonic_encoder_node* pEncoderNode);
+MA_API void ma_ambisonic_encoder_node_set_position(ma_ambisonic_encoder_node* pEncoderNode, const ma_spatializer_listener* pListener, float x, float y, float z);   /* Sets the direction from a world space position relative to the listener's position. */
+
+
+
+/*
+The rotator node has one input and one output, both with `ma_ambisonic_get_channel_count(order)`
+channels. When `pListener` is set the orientation is pulled from the listener at the start of every
+processed block and `ma_ambisonic_rotator_node_set_orientation()` is ignored. When the orientation
+changes the old and new rotations are crossfaded over the block to avoid zipper noise.
+*/
+typedef struct
+{
+    ma_node_config nodeConfig;
+    ma_uint32 order;
+    const ma_spatializer_listener* pListener;   /* Optional. When set, the listener's direction and world up vector drive the rotation. */
+} ma_ambisonic_rotator_node_config;
+
+MA_API ma_ambisonic_rotator_node_config ma_ambisonic_rotator_node_config_init(ma_uint32 order, const ma_spatializer_listener* pListener);
+
+
+typedef struct
+{
+    ma_node_base baseNode;
+    ma_uint32 order;
+    ma_uint32 channels;
+    const ma_spatializer_listener* pListener;
+    ma_spinlock lock;
+    ma_vec3f forward;       /* Protected by the lock. */
+    ma_vec3f up;            /* Protected by the lock. */
+    ma_vec3f appliedForward;
+    ma_vec3f appliedUp;
+    float matrix[MA_AMBISONIC_MAX_CHANNELS*MA_AMBISONIC_MAX_CHANNELS];
+    float targetMatrix[MA_AMBISONIC_MAX_CHANNELS*MA_AMBISONIC_MAX_CHANNELS];
+} ma_ambisonic_rotator_node;
+
+MA_API ma_result ma_ambisonic_rotator_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_rotator_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_rotator_node* pRotatorNode);
+MA_API void ma_ambisonic_rotator_node_uninit(ma_ambisonic_rotator_node* pRotatorNode, const ma_allocation_callbacks* pAllocationCallbacks);
+MA_API void ma_ambisonic_rotator_node_set_orientation(ma_ambisonic_rotator_node* pRotatorNode, ma_vec3f forward, ma_vec3f up);
+
+
+
+/*
+The decoder node has one input with `ma_ambisonic_get_channel_count(order)` channels and one output
+with `channelsOut` channels.
+
+The speaker layout is taken from, in order of priority:
+
+    1) `pDecodeMatrix`, a row-major matrix with one row per output channel and one column per
+       ambisonic channel, used as-is.
+    2) `pSpeakerDirections`, one direction per output channel.
+    3) `pChannelMapOut`, where the direction of each channel position is the same as the one used
+       by the spatializer. LFE channels are left silent. When NULL the default channel map is used.
+
+For (2) and (3) a sampling decoder is built and normalized so that a source has the same average
+energy regardless of the layout. This works best with layouts that cover the sphere reasonably
+evenly. For irregular layouts a matrix from an external design tool can be passed in with (1).
+*/
+typedef struct
+{
+    ma_node_config nodeConfig;
+    ma_uint32 order;
+    ma_uint32 channelsOut;
+    const ma_channel* pChannelMapOut;
+    const ma_vec3f* pSpeakerDirections;
+    const float* pDecodeMatrix;
+    ma_ambisonic_weighting weighting;
+} ma_ambisonic_decoder_node_config;
+
+MA_API ma_ambisonic_decoder_node_config ma_ambisonic_decoder_node_config_init(ma_uint32 order, ma_uint32 channelsOut);
+
+
+typedef struct
+{
+    ma_node_base baseNode;
+    ma_uint32 order;
+    ma_uint32 channelsIn;
+    ma_uint32 channelsOut;
+    float* pMatrix;         /* channelsOut rows of channelsIn columns. */
+} ma_ambisonic_decoder_node;
+
+MA_API ma_result ma_ambisonic_decoder_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_decoder_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_decoder_node* pDecoderNode);
+MA_API void ma_ambisonic_decoder_node_uninit(ma_ambisonic_decoder_node* pDecoderNode, const ma_allocation_callbacks* pAllocationCallbacks);
+
+
+
+/*
+The binaural node has one input with `ma_ambisonic_get_channel_count(order)` channels and one stereo
+output. Rendering is done by convolving each ambisonic channel with a pair of impulse responses
+and summing the results for each ear. The node is a `ma_convolution_node` with a matrix of filters
+underneath, so ma_convolution_node.c needs to be compiled in as well.
+
+Impulse responses are stored one after the other, left ear first:
+
+    pImpulseResponses[(index*2 + ear)*impulseResponseLengthInFrames + frame]
+
+When `pImpulseResponseDirections` is NULL there must be one pair per ambisonic channel (in ACN
+order) and they are used directly. Otherwise there is one pair per direction, typically measured
+HRIRs, and they are combined into per-channel filters at initialization time with a sampling
+decoder to the given virtual speaker directions. The impulse responses are copied and need not be
+kept around after initialization.
+
+The first `partitionSizeInFrames` frames of each filter are convolved in the time domain so there
+is no added latency, and the rest with partitioned FFT convolution. The ambisonic channels are
+summed in the frequency domain, so the cost of the tail is one forward FFT per ambisonic channel
+plus one inverse FFT per ear, regardless of the order. The head is convolved separately for every
+ambisonic channel and ear, which makes it the most expensive part at higher orders. Use a smaller
+partition size to reduce it at the expense of more FFTs.
+*/
+typedef struct
+{
+    ma_node_config nodeConfig;
+    ma_uint32 order;
+    const float* pImpulseResponses;
+    ma_uint32 impulseResponseLengthInFrames;
+    const ma_vec3f* pImpulseResponseDirections;
+    ma_uint32 impulseResponseDirectionCount;
+    ma_ambisonic_weighting weighting;
+    ma_uint32 partitionSizeInFrames;    /* Must be a power of 2 and at least 16. Defaults to 128. See ma_convolution_node_config. */
+} ma_ambisonic_binaural_node_config;
+
+MA_API ma_ambisonic_binaural_node_config ma_ambisonic_binaural_node_config_init(ma_uint32 order, const float* pImpulseResponses, ma_uint32 impulseResponseLengthInFrames);
+
+
+typedef struct
+{
+    ma_convolution_node convolutionNode;    /* Must be the first member so the binaural node can be used as a node. */
+    ma_uint32 order;
+    ma_uint32 channels;
+} ma_ambisonic_binaural_node;
+
+MA_API ma_result ma_ambisonic_binaural_node_init(ma_node_graph* pNodeGraph, const ma_ambisonic_binaural_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_ambisonic_binaural_node* pBinauralNode);
+MA_API void ma_ambisonic_binaural_node_uninit(ma_ambisonic_binaural_node* pBinauralNode, const ma_allocation_callbacks* pAllocationCallbacks);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /* miniaudio_ambisonic_node_h */
@@ -0,0 +1,110 @@
+#include "../../../miniaudio.c"
+#include "ma_ambisonic_node.c"
+#include "../ma_convolution_node/ma_convolution_node.c"
+
+#include <stdio.h>
+
+/*
+This example plays a sound through a third order ambisonic scene. The sound is encoded with a fixed
+direction while the listener slowly turns on the spot, and the rotator node takes care of keeping
+the sound where it is in the world. The scene is decoded to the engine's speaker layout.
+*/
+#define AMBISONIC_ORDER     3
+
+static ma_engine                   g_engine;
+static ma_sound                    g_sound;
+static ma_ambisonic_encoder_node   g_encoderNode;
+static ma_ambisonic_rotator_node   g_rotatorNode;
+static ma_ambisonic_decoder_node   g_decoderNode;
+
+int main(int argc, char** argv)
+{
+    ma_result result;
+    ma_sound_config soundConfig;
+    ma_ambisonic_encoder_node_config encoderNodeConfig;
+    ma_ambisonic_rotator_node_config rotatorNodeConfig;
+    ma_ambisonic_decoder_node_config decoderNodeConfig;
+    float angle = 0;
+
+    if (argc < 2) {
+        printf("No input file.\n");
+        return -1;
+    }
+
+    result = ma_engine_init(NULL, &g_engine);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize engine.\n");
+        return -1;
+    }
+
+
+    /* Decoder. Attached to the endpoint and outputs the same number of channels as the engine. */
+    decoderNodeConfig = ma_ambisonic_decoder_node_config_init(AMBISONIC_ORDER, ma_engine_get_channels(&g_engine));
+
+    result = ma_ambisonic_decoder_node_init(ma_engine_get_node_graph(&g_engine), &decoderNodeConfig, NULL, &g_decoderNode);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize ambisonic decoder node.\n");
+        goto done0;
+    }
+
+    ma_node_attach_output_bus(&g_decoderNode, 0, ma_engine_get_endpoint(&g_engine), 0);
+
+
+    /* Rotator. Driven by the engine's listener. */
+    rotatorNodeConfig = ma_ambisonic_rotator_node_config_init(AMBISONIC_ORDER, &g_engine.listeners[0]);
+
+    result = ma_ambisonic_rotator_node_init(ma_engine_get_node_graph(&g_engine), &rotatorNodeConfig, NULL, &g_rotatorNode);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize ambisonic rotator node.\n");
+        goto done1;
+    }
+
+    ma_node_attach_output_bus(&g_rotatorNode, 0, &g_decoderNode, 0);
+
+
+    /* Encoder. The source sits to the left of where the listener starts. */
+    encoderNodeConfig = ma_ambisonic_encoder_node_config_init(AMBISONIC_ORDER);
+    encoderNodeConfig.direction = ma_vec3f_init_3f(-1, 0, 0);
+
+    result = ma_ambisonic_encoder_node_init(ma_engine_get_node_graph(&g_engine), &encoderNodeConfig, NULL, &g_encoderNode);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize ambisonic encoder node.\n");
+        goto done2;
+    }
+
+    ma_node_attach_output_bus(&g_encoderNode, 0, &g_rotatorNode, 0);
+
+
+    /* The sound. Must be mono and must not be spatialized by the engine. */
+    soundConfig = ma_sound_config_init();
+    soundConfig.pFilePath          = argv[1];
+    soundConfig.pInitialAttachment = &g_encoderNode;
+    soundConfig.channelsOut        = 1;
+    soundConfig.flags              = MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_NO_SPATIALIZATION;
+
+    result = ma_sound_init_ex(&g_engine, &soundConfig, &g_sound);
+    if (result != MA_SUCCESS) {
+        printf("Failed to load sound: %s\n", argv[1]);
+        goto done3;
+    }
+
+    ma_sound_set_looping(&g_sound, MA_TRUE);
+    ma_sound_start(&g_sound);
+
+
+    /* Rotate the listener on the spot. The sound should orbit around the listener. */
+    for (;;) {
+        angle += 0.01f;
+        ma_engine_listener_set_direction(&g_engine, 0, (float)sin(angle), 0, -(float)cos(angle));
+        ma_sleep(10);
+    }
+
+    /* Won't actually get here, but do this to tear down. Sources first, then the decoder at the end of the chain. */
+    ma_sound_uninit(&g_sound);
+done3: ma_ambisonic_encoder_node_uninit(&g_encoderNode, NULL);
+done2: ma_ambisonic_rotator_node_uninit(&g_rotatorNode, NULL);
+done1: ma_ambisonic_decoder_node_uninit(&g_decoderNode, NULL);
+done0: ma_engine_uninit(&g_engine);
+
+    return 0;
+}
@@ -0,0 +1,656 @@
+#ifndef miniaudio_convolution_node_c
+#define miniaudio_convolution_node_c
+
+#include "ma_convolution_node.h"
+
+#include <string.h> /* For memset(). */
+
+#define MA_CONVOLUTION_NODE_STAGE_GROWTH    8   /* Each stage's partitions are this many times larger than the previous stage's. */
+
+struct ma_convolution_node_ir
+{
+    ma_uint32 lengthInFrames;
+    ma_bool32 isMatrix;                                         /* When true there is a filter for every input/output pair and every input is mixed into every output. */
+    float* pHead;                                               /* partitionSizeInFrames taps per filter. */
+    float* pSpectra[MA_CONVOLUTION_NODE_MAX_STAGES];            /* partitionCounts[iStage] spectra per filter. */
+    ma_uint32 partitionCounts[MA_CONVOLUTION_NODE_MAX_STAGES];  /* Can be less than the stage's partition count if this impulse response is shorter than the maximum. */
+};
+
+
+static void ma_convolution_node_get_stage_layout(ma_uint32 partitionSizeInFrames, ma_uint32 lengthInFrames, ma_bool32 uniformPartitions, ma_uint32* pStageCount, ma_uint32* pBlockSizes, ma_uint32* pPartitionCounts)
+{
+    /*
+    The head covers the first partition in the time domain. Each stage after that starts at an
+    offset equal to its own block size, which is what allows its output to be ready in time.
+    */
+    ma_uint32 stageCount = 0;
+    ma_uint32 blockSize = partitionSizeInFrames;
+
+    while (blockSize < lengthInFrames && stageCount < MA_CONVOLUTION_NODE_MAX_STAGES) {
+        ma_uint32 end;
+
+        if (uniformPartitions || stageCount == MA_CONVOLUTION_NODE_MAX_STAGES-1) {
+            end = lengthInFrames;
+        } else {
+            end = blockSize * MA_CONVOLUTION_NODE_STAGE_GROWTH;
+            if (end > lengthInFrames) {
+                end = lengthInFrames;
+            }
+        }
+
+        pBlockSizes     [stageCount] = blockSize;
+        pPartitionCounts[stageCount] = (end - blockSize + blockSize - 1) / blockSize;
+        stageCount += 1;
+
+        if (end == lengthInFrames) {
+            break;
+        }
+
+        blockSize *= MA_CONVOLUTION_NODE_STAGE_GROWTH;
+    }
+
+    *pStageCount = stageCount;
+}
+
+/*
+An output channel is the sum of one or more input channels, each convolved with its own filter. Without a matrix there's
+one filter per output channel applied to the matching input channel, or the only input channel. With a matrix the
+filter for a pair is at inputChannel*channelsOut + outputChannel.
+*/
+static ma_uint32 ma_convolution_node_get_filter_count(const ma_convolution_node* pConvolutionNode, ma_bool32 isMatrix)
+{
+    return isMatrix ? pConvolutionNode->channelsIn * pConvolutionNode->channelsOut : pConvolutionNode->channelsOut;
+}
+
+static ma_uint32 ma_convolution_node_get_pair_count(const ma_convolution_node* pConvolutionNode, const ma_convolution_node_ir* pIR)
+{
+    return pIR->isMatrix ? pConvolutionNode->channelsIn : 1;
+}
+
+static void ma_convolution_node_get_pair(const ma_convolution_node* pConvolutionNode, const ma_convolution_node_ir* pIR, ma_uint32 channelOut, ma_uint32 pairIndex, ma_uint32* pChannelIn, ma_uint32* pFilterIndex)
+{
+    if (pIR->isMatrix) {
+        *pChannelIn   = pairIndex;
+        *pFilterIndex = pairIndex*pConvolutionNode->channelsOut + channelOut;
+    } else {
+        *pChannelIn   = (pConvolutionNode->channelsIn == 1) ? 0 : channelOut;
+        *pFilterIndex = channelOut;
+    }
+}
+
+/* pWorkspace must have room for the largest FFT. */
+static ma_result ma_convolution_node_ir_create(const ma_convolution_node* pConvolutionNode, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 lengthInFrames, float* pWorkspace, const ma_allocation_callbacks* pAllocationCallbacks, ma_convolution_node_ir** ppIR)
+{
+    ma_convolution_node_ir* pIR;
+    ma_uint32 channelsIn  = pConvolutionNode->channelsIn;
+    ma_uint32 channelsOut = pConvolutionNode->channelsOut;
+    ma_uint32 partitionSize = pConvolutionNode->partitionSizeInFrames;
+    ma_bool32 isMatrix;
+    ma_uint32 filterCount;
+    size_t sizeInFloats;
+    float* pRunning;
+    ma_uint32 iStage;
+    ma_uint32 iChannel;
+    ma_uint32 iFrame;
+    ma_uint32 iPartition;
+
+    *ppIR = NULL;
+
+    if (pImpulseResponse == NULL || lengthInFrames == 0 || lengthInFrames > pConvolutionNode->maxImpulseResponseLengthInFrames) {
+        return MA_INVALID_ARGS;
+    }
+
+    isMatrix = (channelsIn > 1 && impulseResponseChannels == channelsIn*channelsOut);
+    if (!isMatrix) {
+        if (impulseResponseChannels != 1 && impulseResponseChannels != channelsOut) {
+            return MA_INVALID_ARGS;
+        }
+
+        if (channelsIn != 1 && channelsIn != channelsOut) {
+            return MA_INVALID_ARGS; /* Only a matrix can mix a different number of input channels into the output. */
+        }
+    }
+
+    filterCount = ma_convolution_node_get_filter_count(pConvolutionNode, isMatrix);
+
+    /* Work out how many partitions of each stage this impulse response actually needs. */
+    sizeInFloats = (size_t)filterCount * partitionSize;
+    for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+        const ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+        ma_uint32 blockSize = pStage->blockSizeInFrames;
+        ma_uint32 partitionCount = 0;
+
+        if (lengthInFrames > blockSize) {
+            partitionCount = (lengthInFrames - blockSize + blockSize - 1) / blockSize;
+            if (partitionCount > pStage->partitionCount) {
+                partitionCount = pStage->partitionCount;
+            }
+        }
+
+        sizeInFloats += (size_t)filterCount * partitionCount * blockSize*2;
+    }
+
+    pIR = (ma_convolution_node_ir*)ma_malloc(sizeof(*pIR) + sizeInFloats * sizeof(float), pAllocationCallbacks);
+    if (pIR == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    memset(pIR, 0, sizeof(*pIR));
+    pIR->lengthInFrames = lengthInFrames;
+    pIR->isMatrix       = isMatrix;
+
+    pRunning = (float*)(pIR + 1);
+
+    /* The head is stored as-is. */
+    pIR->pHead = pRunning;
+    pRunning += filterCount * partitionSize;
+
+    for (iChannel = 0; iChannel < filterCount; iChannel += 1) {
+        ma_uint32 iChannelIR = (impulseResponseChannels == 1) ? 0 : iChannel;
+
+        for (iFrame = 0; iFrame < partitionSize; iFrame += 1) {
+            pIR->pHead[iChannel*partitionSize + iFrame] = (iFrame < lengthInFrames) ? pImpulseResponse[iFrame*impulseResponseChannels + iChannelIR] : 0;
+        }
+    }
+
+    /* Everything else is transformed one partition at a time. */
+    for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+        const ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+        ma_uint32 blockSize = pStage->blockSizeInFrames;
+        ma_uint32 partitionCount = 0;
+        float scale = 1.0f / (blockSize*2);    /* Normalization for the inverse FFT. */
+
+        if (lengthInFrames > blockSize) {
+            partitionCount = (lengthInFrames - blockSize + blockSize - 1) / blockSize;
+            if (partitionCount > pStage->partitionCount) {
+                partitionCount = pStage->partitionCount;
+            }
+        }
+
+        pIR->partitionCounts[iStage] = partitionCount;
+        pIR->pSpectra[iStage] = pRunning;
+        pRunning += filterCount * partitionCount * blockSize*2;
+
+        for (iChannel = 0; iChannel < filterCount; iChannel += 1) {
+            ma_uint32 iChannelIR = (impulseResponseChannels == 1) ? 0 : iChannel;
+
+            for (iPartition = 0; iPartition < partitionCount; iPartition += 1) {
+                float* pSpectrum = pIR->pSpectra[iStage] + (iChannel*partitionCount + iPartition)*blockSize*2;
+                ma_uint32 firstFrame = blockSize + iPartition*blockSize;
+                ma_uint32 k;
+
+                /* The partition goes into the first half of the FFT buffer. The second half is zero. */
+                for (iFrame = 0; iFrame < blockSize*2; iFrame += 1) {
+                    ma_uint32 iFrameIR = firstFrame + iFrame;
+                    pWorkspace[iFrame] = (iFrame < blockSize && iFrameIR < lengthInFrames) ? pImpulseResponse[iFrameIR*impulseResponseChannels + iChannelIR] : 0;
+                }
+
+                ma_fft_forward(&pStage->fft, pSpectrum, pWorkspace);
+
+                for (k = 0; k < blockSize*2; k += 1) {
+                    pSpectrum[k] *= scale;
+                }
+            }
+        }
+    }
+
+    *ppIR = pIR;
+    return MA_SUCCESS;
+}
+
+
+static void ma_convolution_node_compute_stage(ma_convolution_node* pConvolutionNode, ma_uint32 stageIndex)
+{
+    ma_convolution_node_stage* pStage = &pConvolutionNode->stages[stageIndex];
+    ma_uint32 blockSize = pStage->blockSizeInFrames;
+    ma_uint32 fftSize = blockSize*2;
+    ma_uint32 partitionCount = pStage->partitionCount;
+    ma_uint32 iChannelIn;
+    ma_uint32 iChannelOut;
+    ma_uint32 iSlot;
+
+    /* Push the newest block of each input channel into the delay line. */
+    pStage->spectrumIndex = (pStage->spectrumIndex + 1) % partitionCount;
+
+    for (iChannelIn = 0; iChannelIn < pConvolutionNode->channelsIn; iChannelIn += 1) {
+        float* pInput = pStage->pInput + iChannelIn*fftSize;
+
+        ma_fft_forward(&pStage->fft, pStage->pSpectra + (iChannelIn*partitionCount + pStage->spectrumIndex)*fftSize, pInput);
+
+        /* The current block becomes the previous block. */
+        memcpy(pInput, pInput + blockSize, blockSize * sizeof(float));
+    }
+
+    for (iSlot = 0; iSlot < 2; iSlot += 1) {
+        const ma_convolution_node_ir* pIR = (iSlot == 0) ? pConvolutionNode->pIR : pConvolutionNode->pFadingIR;
+        ma_uint32 irPartitionCount;
+
+        if (pIR == NULL) {
+            continue;
+        }
+
+        irPartitionCount = pIR->partitionCounts[stageIndex];
+
+        for (iChannelOut = 0; iChannelOut < pConvolutionNode->channelsOut; iChannelOut += 1) {
+            float* pOutput = pStage->pOutput[iSlot] + iChannelOut*blockSize;
+            ma_uint32 pairCount = ma_convolution_node_get_pair_count(pConvolutionNode, pIR);
+            ma_uint32 iPair;
+            ma_uint32 iPartition;
+
+            if (irPartitionCount == 0) {
+                memset(pOutput, 0, blockSize * sizeof(float));
+                continue;
+            }
+
+            /* Every input is accumulated in the frequency domain so there's only one inverse FFT per output channel. */
+            memset(pConvolutionNode->pSpectrum, 0, fftSize * sizeof(float));
+
+            for (iPair = 0; iPair < pairCount; iPair += 1) {
+                ma_uint32 iFilter;
+
+                ma_convolution_node_get_pair(pConvolutionNode, pIR, iChannelOut, iPair, &iChannelIn, &iFilter);
+
+                for (iPartition = 0; iPartition < irPartitionCount; iPartition += 1) {
+                    ma_uint32 iSpectrum = (pStage->spectrumIndex + partitionCount - iPartition) % partitionCount;
+
+                    ma_fft_spectrum_multiply_add(
+                        pConvolutionNode->pSpectrum,
+                        pStage->pSpectra + (iChannelIn*partitionCount + iSpectrum)*fftSize,
+                        pIR->pSpectra[stageIndex] + (iFilter*irPartitionCount + iPartition)*fftSize,
+                        fftSize);
+                }
+            }
+
+            ma_fft_inverse(&pStage->fft, pConvolutionNode->pScratch, pConvolutionNode->pSpectrum);
+
+            /* Overlap-save. Only the second half is a valid part of the linear convolution. */
+            memcpy(pOutput, pConvolutionNode->pScratch + blockSize, blockSize * sizeof(float));
+        }
+    }
+}
+
+static void ma_convolution_node_try_swap(ma_convolution_node* pConvolutionNode)
+{
+    ma_spinlock_lock(&pConvolutionNode->lock);
+    {
+        /* A new impulse response is only picked up once the previous fade has been cleaned up. */
+        if (pConvolutionNode->pPendingIR != NULL && pConvolutionNode->pRetiredIR == NULL) {
+            if (pConvolutionNode->crossfadeLengthInFrames == 0) {
+                pConvolutionNode->pRetiredIR = pConvolutionNode->pIR;
+            } else {
+                pConvolutionNode->pFadingIR = pConvolutionNode->pIR;
+            }
+
+            pConvolutionNode->pIR        = pConvolutionNode->pPendingIR;
+            pConvolutionNode->pPendingIR = NULL;
+            pConvolutionNode->crossfadeCursor = 0;
+        }
+    }
+    ma_spinlock_unlock(&pConvolutionNode->lock);
+}
+
+static float ma_convolution_node_head(const ma_convolution_node* pConvolutionNode, const ma_convolution_node_ir* pIR, ma_uint32 channelOut, ma_uint32 positionInPartition)
+{
+    ma_uint32 partitionSize = pConvolutionNode->partitionSizeInFrames;
+    ma_uint32 pairCount = ma_convolution_node_get_pair_count(pConvolutionNode, pIR);
+    float y = 0;
+    ma_uint32 iPair;
+    ma_uint32 iTap;
+
+    for (iPair = 0; iPair < pairCount; iPair += 1) {
+        const float* pHistory;
+        const float* pHead;
+        ma_uint32 iChannelIn;
+        ma_uint32 iFilter;
+
+        ma_convolution_node_get_pair(pConvolutionNode, pIR, channelOut, iPair, &iChannelIn, &iFilter);
+
+        /* pHistory[-k] is the input k frames ago. */
+        pHistory = pConvolutionNode->pHistory + iChannelIn*(partitionSize*2 - 1) + (partitionSize - 1) + positionInPartition;
+        pHead    = pIR->pHead + iFilter*partitionSize;
+
+        for (iTap = 0; iTap < partitionSize; iTap += 1) {
+            y += pHead[iTap] * pHistory[-(ma_int32)iTap];
+        }
+    }
+
+    return y;
+}
+
+static void ma_convolution_node_process_pcm_frames(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    ma_convolution_node* pConvolutionNode = (ma_convolution_node*)pNode;
+    const float* pFramesIn  = ppFramesIn[0];
+    float* pFramesOut = ppFramesOut[0];
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 channelsIn  = pConvolutionNode->channelsIn;
+    ma_uint32 channelsOut = pConvolutionNode->channelsOut;
+    ma_uint32 partitionSize = pConvolutionNode->partitionSizeInFrames;
+    ma_uint32 historyStride = partitionSize*2 - 1;
+    ma_uint32 largestBlockSize;
+    ma_uint32 totalFramesProcessed = 0;
+
+    (void)pFrameCountIn;
+
+    largestBlockSize = (pConvolutionNode->stageCount > 0) ? pConvolutionNode->stages[pConvolutionNode->stageCount-1].blockSizeInFrames : partitionSize;
+
+    while (totalFramesProcessed < frameCount) {
+        /* Never cross a partition boundary within a single iteration. */
+        ma_uint32 positionInPartition = (ma_uint32)(pConvolutionNode->cursor % partitionSize);
+        ma_uint32 framesToProcess = partitionSize - positionInPartition;
+        ma_uint32 iChannelIn;
+        ma_uint32 iChannelOut;
+        ma_uint32 iStage;
+        ma_uint32 iFrame;
+
+        if (framesToProcess > frameCount - totalFramesProcessed) {
+            framesToProcess = frameCount - totalFramesProcessed;
+        }
+
+        /* Input goes into the head's history and each stage's current block. */
+        for (iChannelIn = 0; iChannelIn < channelsIn; iChannelIn += 1) {
+            float* pHistory = pConvolutionNode->pHistory + iChannelIn*historyStride + (partitionSize - 1) + positionInPartition;
+
+            for (iFrame = 0; iFrame < framesToProcess; iFrame += 1) {
+                pHistory[iFrame] = pFramesIn[(totalFramesProcessed + iFrame)*channelsIn + iChannelIn];
+            }
+
+            for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+                ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+                ma_uint32 blockSize = pStage->blockSizeInFrames;
+                memcpy(pStage->pInput + iChannelIn*blockSize*2 + blockSize + (pConvolutionNode->cursor % blockSize), pHistory, framesToProcess * sizeof(float));
+            }
+        }
+
+        for (iChannelOut = 0; iChannelOut < channelsOut; iChannelOut += 1) {
+            float* pOut = pFramesOut + totalFramesProcessed*channelsOut + iChannelOut;
+
+            for (iFrame = 0; iFrame < framesToProcess; iFrame += 1) {
+                pOut[iFrame*channelsOut] = ma_convolution_node_head(pConvolutionNode, pConvolutionNode->pIR, iChannelOut, positionInPartition + iFrame);
+            }
+
+            for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+                const ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+                const float* pStageOut = pStage->pOutput[0] + iChannelOut*pStage->blockSizeInFrames + (pConvolutionNode->cursor % pStage->blockSizeInFrames);
+
+                for (iFrame = 0; iFrame < framesToProcess; iFrame += 1) {
+                    pOut[iFrame*channelsOut] += pStageOut[iFrame];
+                }
+            }
+
+            if (pConvolutionNode->pFadingIR != NULL) {
+                for (iFrame = 0; iFrame < framesToProcess; iFrame += 1) {
+                    ma_uint32 fadePosition = pConvolutionNode->crossfadeCursor + iFrame;
+                    float yOld;
+                    float t;
+
+                    if (fadePosition >= pConvolutionNode->crossfadeLengthInFrames) {
+                        break;
+                    }
+
+                    yOld = ma_convolution_node_head(pConvolutionNode, pConvolutionNode->pFadingIR, iChannelOut, positionInPartition + iFrame);
+                    for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+                        const ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+                        yOld += pStage->pOutput[1][iChannelOut*pStage->blockSizeInFrames + (pConvolutionNode->cursor % pStage->blockSizeInFrames) + iFrame];
+                    }
+
+                    t = (float)(fadePosition + 1) / pConvolutionNode->crossfadeLengthInFrames;
+                    pOut[iFrame*channelsOut] = yOld + (pOut[iFrame*channelsOut] - yOld)*t;
+                }
+            }
+        }
+
+        pConvolutionNode->cursor += framesToProcess;
+        totalFramesProcessed     += framesToProcess;
+
+        if (pConvolutionNode->pFadingIR != NULL) {
+            pConvolutionNode->crossfadeCursor += framesToProcess;
+
+            if (pConvolutionNode->crossfadeCursor >= pConvolutionNode->crossfadeLengthInFrames) {
+                ma_spinlock_lock(&pConvolutionNode->lock);
+                {
+                    pConvolutionNode->pRetiredIR = pConvolutionNode->pFadingIR;
+                }
+                ma_spinlock_unlock(&pConvolutionNode->lock);
+
+                pConvolutionNode->pFadingIR = NULL;
+            }
+        }
+
+        if ((pConvolutionNode->cursor % partitionSize) == 0) {
+            /* Keep the tail of the history for the next partition. */
+            for (iChannelIn = 0; iChannelIn < channelsIn; iChannelIn += 1) {
+                float* pHistory = pConvolutionNode->pHistory + iChannelIn*historyStride;
+                memmove(pHistory, pHistory + partitionSize, (partitionSize - 1) * sizeof(float));
+            }
+
+            /* Changes are only made when every stage is at the end of a block so they all switch over together. */
+            if (pConvolutionNode->pFadingIR == NULL && (pConvolutionNode->cursor % largestBlockSize) == 0) {
+                ma_convolution_node_try_swap(pConvolutionNode);
+            }
+
+            for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+                if ((pConvolutionNode->cursor % pConvolutionNode->stages[iStage].blockSizeInFrames) == 0) {
+                    ma_convolution_node_compute_stage(pConvolutionNode, iStage);
+                }
+            }
+        }
+    }
+}
+
+static ma_node_vtable g_ma_convolution_node_vtable =
+{
+    ma_convolution_node_process_pcm_frames,
+    NULL,
+    1,  /* 1 input bus. */
+    1,  /* 1 output bus. */
+    MA_NODE_FLAG_CONTINUOUS_PROCESSING  /* Continuous processing so the tail of the impulse response gets processed. */
+};
+
+
+MA_API ma_convolution_node_config ma_convolution_node_config_init(ma_uint32 channelsIn, ma_uint32 channelsOut, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 impulseResponseLengthInFrames)
+{
+    ma_convolution_node_config config;
+
+    memset(&config, 0, sizeof(config));
+    config.nodeConfig  = ma_node_config_init();  /* Input and output channels will be set in ma_convolution_node_init(). */
+    config.channelsIn  = channelsIn;
+    config.channelsOut = channelsOut;
+    config.pImpulseResponse = pImpulseResponse;
+    config.impulseResponseChannels = impulseResponseChannels;
+    config.impulseResponseLengthInFrames = impulseResponseLengthInFrames;
+    config.partitionSizeInFrames   = 128;
+    config.crossfadeLengthInFrames = 1024;
+
+    return config;
+}
+
+MA_API ma_result ma_convolution_node_init(ma_node_graph* pNodeGraph, const ma_convolution_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_convolution_node* pConvolutionNode)
+{
+    ma_result result;
+    ma_node_config baseConfig;
+    ma_uint32 channelsIn;
+    ma_uint32 channelsOut;
+    ma_uint32 partitionSize;
+    ma_uint32 maxLength;
+    ma_uint32 blockSizes[MA_CONVOLUTION_NODE_MAX_STAGES];
+    ma_uint32 partitionCounts[MA_CONVOLUTION_NODE_MAX_STAGES];
+    ma_uint32 largestFFTSize;
+    ma_fft_config fftConfig;
+    size_t fftHeapSizeInBytes;
+    size_t heapSizeInFloats;
+    float* pRunning;
+    ma_uint32 iStage;
+
+    if (pConvolutionNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    memset(pConvolutionNode, 0, sizeof(*pConvolutionNode));
+
+    if (pConfig == NULL || pConfig->channelsIn == 0 || pConfig->channelsOut == 0) {
+        return MA_INVALID_ARGS; /* The rest of the channel layout is validated against the impulse response. */
+    }
+
+    partitionSize = pConfig->partitionSizeInFrames;
+    if (partitionSize < 16 || (partitionSize & (partitionSize - 1)) != 0) {
+        return MA_INVALID_ARGS;
+    }
+
+    maxLength = pConfig->maxImpulseResponseLengthInFrames;
+    if (maxLength == 0) {
+        maxLength = pConfig->impulseResponseLengthInFrames;
+    }
+
+    if (maxLength < pConfig->impulseResponseLengthInFrames) {
+        return MA_INVALID_ARGS;
+    }
+
+    channelsIn  = pConfig->channelsIn;
+    channelsOut = pConfig->channelsOut;
+
+    pConvolutionNode->channelsIn  = channelsIn;
+    pConvolutionNode->channelsOut = channelsOut;
+    pConvolutionNode->partitionSizeInFrames = partitionSize;
+    pConvolutionNode->maxImpulseResponseLengthInFrames = maxLength;
+    pConvolutionNode->crossfadeLengthInFrames = pConfig->crossfadeLengthInFrames;
+
+    ma_convolution_node_get_stage_layout(partitionSize, maxLength, pConfig->uniformPartitions, &pConvolutionNode->stageCount, blockSizes, partitionCounts);
+
+    /* Everything goes into a single allocation. The FFT heaps are always a multiple of the size of a float. */
+    largestFFTSize   = partitionSize*2;
+    heapSizeInFloats = (size_t)channelsIn * (partitionSize*2 - 1);
+
+    for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+        ma_uint32 blockSize = blockSizes[iStage];
+
+        heapSizeInFloats += (size_t)channelsIn  * blockSize*2;                          /* Input. */
+        heapSizeInFloats += (size_t)channelsIn  * partitionCounts[iStage] * blockSize*2; /* Spectra. */
+        heapSizeInFloats += (size_t)channelsOut * blockSize * 2;                        /* Output. */
+
+        fftConfig = ma_fft_config_init(blockSize*2);
+        result = ma_fft_get_heap_size(&fftConfig, &fftHeapSizeInBytes);
+        if (result != MA_SUCCESS) {
+            return result;
+        }
+
+        heapSizeInFloats += fftHeapSizeInBytes / sizeof(float);                         /* FFT. */
+
+        largestFFTSize = blockSize*2;
+    }
+
+    heapSizeInFloats += (size_t)largestFFTSize * 2;    /* Spectrum and scratch. */
+
+    pConvolutionNode->_pHeap = ma_malloc(heapSizeInFloats * sizeof(float), pAllocationCallbacks);
+    if (pConvolutionNode->_pHeap == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    memset(pConvolutionNode->_pHeap, 0, heapSizeInFloats * sizeof(float));
+    pRunning = (float*)pConvolutionNode->_pHeap;
+
+    pConvolutionNode->pHistory  = pRunning; pRunning += channelsIn * (partitionSize*2 - 1);
+    pConvolutionNode->pSpectrum = pRunning; pRunning += largestFFTSize;
+    pConvolutionNode->pScratch  = pRunning; pRunning += largestFFTSize;
+
+    for (iStage = 0; iStage < pConvolutionNode->stageCount; iStage += 1) {
+        ma_convolution_node_stage* pStage = &pConvolutionNode->stages[iStage];
+        ma_uint32 blockSize = blockSizes[iStage];
+
+        pStage->blockSizeInFrames = blockSize;
+        pStage->partitionCount    = partitionCounts[iStage];
+        pStage->pInput     = pRunning; pRunning += channelsIn * blockSize*2;
+        pStage->pSpectra   = pRunning; pRunning += channelsIn * partitionCounts[iStage] * blockSize*2;
+        pStage->pOutput[0] = pRunning; pRunning += channelsOut * blockSize;
+        pStage->pOutput[1] = pRunning; pRunning += channelsOut * blockSize;
+
+        fftConfig = ma_fft_config_init(blockSize*2);
+        ma_fft_get_heap_size(&fftConfig, &fftHeapSizeInBytes);
+        ma_fft_init_preallocated(&fftConfig, pRunning, &pStage->fft);   /* Can't fail since the config has already been validated. */
+        pRunning += fftHeapSizeInBytes / sizeof(float);
+    }
+
+    /* The spectrum buffer can be used as the workspace since the audio thread isn't running yet. */
+    result = ma_convolution_node_ir_create(pConvolutionNode, pConfig->pImpulseResponse, pConfig->impulseResponseChannels, pConfig->impulseResponseLengthInFrames, pConvolutionNode->pSpectrum, pAllocationCallbacks, &pConvolutionNode->pIR);
+    if (result != MA_SUCCESS) {
+        ma_free(pConvolutionNode->_pHeap, pAllocationCallbacks);
+        return result;
+    }
+
+    baseConfig = pConfig->nodeConfig;
+    baseConfig.vtable          = &g_ma_convolution_node_vtable;
+    baseConfig.pInputChannels  = &channelsIn;
+    baseConfig.pOutputChannels = &channelsOut;
+
+    result = ma_node_init(pNodeGraph, &baseConfig, pAllocationCallbacks, &pConvolutionNode->baseNode);
+    if (result != MA_SUCCESS) {
+        ma_free(pConvolutionNode->pIR, pAllocationCallbacks);
+        ma_free(pConvolutionNode->_pHeap, pAllocationCallbacks);
+        return result;
+    }
+
+    return MA_SUCCESS;
+}
+
+MA_API void ma_convolution_node_uninit(ma_convolution_node* pConvolutionNode, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    if (pConvolutionNode == NULL) {
+        return;
+    }
+
+    /* The base node is always uninitialized first. */
+    ma_node_uninit(pConvolutionNode, pAllocationCallbacks);
+
+    ma_free(pConvolutionNode->pIR,        pAllocationCallbacks);
+    ma_free(pConvolutionNode->pFadingIR,  pAllocationCallbacks);
+    ma_free(pConvolutionNode->pPendingIR, pAllocationCallbacks);
+    ma_free(pConvolutionNode->pRetiredIR, pAllocationCallbacks);
+    ma_free(pConvolutionNode->_pHeap,     pAllocationCallbacks);
+}
+
+MA_API ma_result ma_convolution_node_set_impulse_response(ma_convolution_node* pConvolutionNode, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 impulseResponseLengthInFrames, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    ma_result result;
+    ma_convolution_node_ir* pNewIR;
+    ma_convolution_node_ir* pOldPendingIR;
+    ma_convolution_node_ir* pRetiredIR;
+    ma_uint32 largestFFTSize;
+    float* pWorkspace = NULL;
+
+    if (pConvolutionNode == NULL) {
+        return MA_INVALID_ARGS;
+    }
+
+    /* The node's workspace can't be used here because the audio thread might be using it at the same time. */
+    largestFFTSize = (pConvolutionNode->stageCount > 0) ? pConvolutionNode->stages[pConvolutionNode->stageCount-1].blockSizeInFrames*2 : 0;
+    if (largestFFTSize > 0) {
+        pWorkspace = (float*)ma_malloc(largestFFTSize * sizeof(float), pAllocationCallbacks);
+        if (pWorkspace == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+    }
+
+    result = ma_convolution_node_ir_create(pConvolutionNode, pImpulseResponse, impulseResponseChannels, impulseResponseLengthInFrames, pWorkspace, pAllocationCallbacks, &pNewIR);
+    ma_free(pWorkspace, pAllocationCallbacks);
+
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    ma_spinlock_lock(&pConvolutionNode->lock);
+    {
+        pOldPendingIR = pConvolutionNode->pPendingIR;   /* Never picked up by the audio thread. */
+        pRetiredIR    = pConvolutionNode->pRetiredIR;
+
+        pConvolutionNode->pPendingIR = pNewIR;
+        pConvolutionNode->pRetiredIR = NULL;
+    }
+    ma_spinlock_unlock(&pConvolutionNode->lock);
+
+    ma_free(pOldPendingIR, pAllocationCallbacks);
+    ma_free(pRetiredIR,    pAllocationCallbacks);
+
+    return MA_SUCCESS;
+}
+
+#endif  /* miniaudio_convolution_node_c */
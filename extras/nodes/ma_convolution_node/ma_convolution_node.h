@@ -0,0 +1,112 @@
+/* Include ma_convolution_node.h after miniaudio.h */
+#ifndef miniaudio_convolution_node_h
+#define miniaudio_convolution_node_h
+
+#include "../../../miniaudio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+The convolution node has one input and one output. It convolves the input with an impulse response
+which can be used for convolution reverb, cabinet simulation, HRTF rendering, etc.
+
+The input must have either one channel, or the same number of channels as the output. The impulse
+response must also have either one channel, or the same number of channels as the output. Each
+output channel is the convolution of its input channel (or the only input channel) with its
+impulse response channel (or the only impulse response channel). With a mono input and a stereo
+impulse response, for example, the node acts as a mono to binaural renderer.
+
+The impulse response can instead have `channelsIn * channelsOut` channels, in which case it's a
+matrix of filters and the input can have any number of channels. Every output channel is then the
+sum of every input channel convolved with its own filter, where the filter for an input and output
+channel pair is impulse response channel `inputChannel*channelsOut + outputChannel`. The inputs are
+summed in the frequency domain so there is still only one inverse FFT per output channel. This is
+what the ambisonic binaural node uses to render a whole ambisonic stream to headphones.
+
+There is no added latency. The first partition of the impulse response is convolved directly in the
+time domain, and the remainder in the frequency domain with partitioned overlap-save convolution.
+By default the partitions grow by a factor of 8 every 7 partitions for long impulse responses,
+which keeps the cost of multi-second reverbs low. Set `uniformPartitions` to use a single partition
+size for the whole impulse response, which spreads the cost more evenly between callbacks at the
+expense of more work overall.
+
+Be aware that growing partitions make the cost of each callback uneven. The work for a partition is
+done all at once on the audio thread in the callback where its last frame arrives, rather than
+being spread over the frames of the next partition. With the default partition size of 128 that
+means a 2048 point FFT every 1024 frames and a 16384 point FFT every 8192 frames on top of the
+regular work, so the callbacks where those line up take several times longer than the average. The
+average is what matters for overall CPU usage, but the worst case is what needs to fit within the
+period. If the worst case is a problem, use `uniformPartitions`, use a smaller partition size, or
+run the node graph with a larger period so that the spikes are a smaller part of each callback.
+
+The impulse response can be changed while the node is running with
+`ma_convolution_node_set_impulse_response()`. The new impulse response is prepared on the calling
+thread and crossfaded in on the audio thread once the largest partition size lines up, which means
+the switch can take up to 64 partitions worth of frames to start. The length of any new impulse
+response cannot exceed `maxImpulseResponseLengthInFrames`.
+*/
+#define MA_CONVOLUTION_NODE_MAX_STAGES  3
+
+typedef struct ma_convolution_node_ir ma_convolution_node_ir;
+
+typedef struct
+{
+    ma_node_config nodeConfig;
+    ma_uint32 channelsIn;                       /* Must be 1 or equal to channelsOut, unless the impulse response is a matrix. */
+    ma_uint32 channelsOut;
+    const float* pImpulseResponse;              /* Interleaved. Copied during initialization. */
+    ma_uint32 impulseResponseChannels;          /* Must be 1, equal to channelsOut, or channelsIn*channelsOut for a matrix. */
+    ma_uint32 impulseResponseLengthInFrames;
+    ma_uint32 maxImpulseResponseLengthInFrames; /* The longest impulse response that can be swapped in later. Set to 0 to use impulseResponseLengthInFrames. */
+    ma_uint32 partitionSizeInFrames;            /* Must be a power of 2 and at least 16. Defaults to 128. Smaller is cheaper on the head of the impulse response but more expensive on the rest. */
+    ma_bool32 uniformPartitions;                /* Set to true to disable growing partitions for long impulse responses. */
+    ma_uint32 crossfadeLengthInFrames;          /* How long to crossfade between impulse responses when changing them. Defaults to 1024. */
+} ma_convolution_node_config;
+
+MA_API ma_convolution_node_config ma_convolution_node_config_init(ma_uint32 channelsIn, ma_uint32 channelsOut, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 impulseResponseLengthInFrames);
+
+
+typedef struct
+{
+    ma_uint32 blockSizeInFrames;        /* The partition size of this stage. The FFT is twice this size. */
+    ma_uint32 partitionCount;           /* The maximum number of partitions, based on maxImpulseResponseLengthInFrames. */
+    ma_uint32 spectrumIndex;            /* The slot in pSpectra holding the most recent input spectrum. */
+    float* pInput;                      /* Two blocks of input per input channel. The previous block followed by the current one. */
+    float* pSpectra;                    /* Frequency domain delay line. partitionCount spectra per input channel. */
+    float* pOutput[2];                  /* One block of output per output channel. [0] is for the current impulse response, [1] for the one being faded out. */
+    ma_fft fft;                         /* Twice the block size. */
+} ma_convolution_node_stage;
+
+typedef struct
+{
+    ma_node_base baseNode;
+    ma_uint32 channelsIn;
+    ma_uint32 channelsOut;
+    ma_uint32 partitionSizeInFrames;
+    ma_uint32 maxImpulseResponseLengthInFrames;
+    ma_uint32 crossfadeLengthInFrames;
+    ma_uint32 crossfadeCursor;
+    ma_uint32 stageCount;
+    ma_uint64 cursor;                   /* The number of frames processed. Used to know when each stage reaches the end of a block. */
+    ma_convolution_node_stage stages[MA_CONVOLUTION_NODE_MAX_STAGES];
+    float* pHistory;                    /* Input for the time domain head. The last partitionSizeInFrames-1 frames followed by the current block for each input channel. */
+    float* pSpectrum;                   /* Workspace for accumulating a spectrum. */
+    float* pScratch;                    /* Workspace for the inverse FFT. */
+    ma_convolution_node_ir* pIR;        /* Only accessed from the audio thread. */
+    ma_convolution_node_ir* pFadingIR;  /* Only accessed from the audio thread. The impulse response being faded out. */
+    ma_spinlock lock;
+    ma_convolution_node_ir* pPendingIR; /* Protected by the lock. Set by ma_convolution_node_set_impulse_response() and picked up by the audio thread. */
+    ma_convolution_node_ir* pRetiredIR; /* Protected by the lock. Set by the audio thread when a fade has completed and freed on the next change or at uninit. */
+    void* _pHeap;
+} ma_convolution_node;
+
+MA_API ma_result ma_convolution_node_init(ma_node_graph* pNodeGraph, const ma_convolution_node_config* pConfig, const ma_allocation_callbacks* pAllocationCallbacks, ma_convolution_node* pConvolutionNode);
+MA_API void ma_convolution_node_uninit(ma_convolution_node* pConvolutionNode, const ma_allocation_callbacks* pAllocationCallbacks);
+MA_API ma_result ma_convolution_node_set_impulse_response(ma_convolution_node* pConvolutionNode, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 impulseResponseLengthInFrames, const ma_allocation_callbacks* pAllocationCallbacks);   /* The allocation callbacks must be the same as those used with ma_convolution_node_init(). */
+
+#ifdef __cplusplus
+}
+#endif
+#endif  /* miniaudio_convolution_node_h */
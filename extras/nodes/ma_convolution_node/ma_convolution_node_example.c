@@ -0,0 +1,83 @@
+#include "../../../miniaudio.c"
+#include "ma_convolution_node.c"
+
+#include <stdio.h>
+
+/*
+This example plays a sound through a convolution reverb. The first argument is the sound to play and
+the second is the impulse response. The impulse response is converted to the engine's channel count
+and sample rate when it's loaded.
+*/
+static ma_engine           g_engine;
+static ma_sound            g_sound;
+static ma_convolution_node g_convolutionNode;
+
+int main(int argc, char** argv)
+{
+    ma_result result;
+    ma_decoder_config decoderConfig;
+    ma_uint64 impulseResponseLengthInFrames;
+    void* pImpulseResponse;
+    ma_convolution_node_config convolutionNodeConfig;
+    ma_sound_config soundConfig;
+    ma_uint32 channels;
+
+    if (argc < 3) {
+        printf("Usage: ma_convolution_node_example <sound> <impulse response>\n");
+        return -1;
+    }
+
+    result = ma_engine_init(NULL, &g_engine);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize engine.\n");
+        return -1;
+    }
+
+    channels = ma_engine_get_channels(&g_engine);
+
+
+    /* The impulse response is decoded in full. The node makes its own copy so it can be freed straight after. */
+    decoderConfig = ma_decoder_config_init(ma_format_f32, channels, ma_engine_get_sample_rate(&g_engine));
+
+    result = ma_decode_file(argv[2], &decoderConfig, &impulseResponseLengthInFrames, &pImpulseResponse);
+    if (result != MA_SUCCESS) {
+        printf("Failed to load impulse response: %s\n", argv[2]);
+        goto done0;
+    }
+
+    convolutionNodeConfig = ma_convolution_node_config_init(channels, channels, (const float*)pImpulseResponse, channels, (ma_uint32)impulseResponseLengthInFrames);
+
+    result = ma_convolution_node_init(ma_engine_get_node_graph(&g_engine), &convolutionNodeConfig, NULL, &g_convolutionNode);
+    ma_free(pImpulseResponse, &decoderConfig.allocationCallbacks);
+
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize convolution node.\n");
+        goto done0;
+    }
+
+    ma_node_attach_output_bus(&g_convolutionNode, 0, ma_engine_get_endpoint(&g_engine), 0);
+
+
+    /* The sound is attached to the convolution node rather than the endpoint. */
+    soundConfig = ma_sound_config_init();
+    soundConfig.pFilePath          = argv[1];
+    soundConfig.pInitialAttachment = &g_convolutionNode;
+    soundConfig.flags              = MA_SOUND_FLAG_DECODE;
+
+    result = ma_sound_init_ex(&g_engine, &soundConfig, &g_sound);
+    if (result != MA_SUCCESS) {
+        printf("Failed to load sound: %s\n", argv[1]);
+        goto done1;
+    }
+
+    ma_sound_start(&g_sound);
+
+    printf("Press Enter to quit...\n");
+    getchar();
+
+    ma_sound_uninit(&g_sound);
+done1: ma_convolution_node_uninit(&g_convolutionNode, NULL);
+done0: ma_engine_uninit(&g_engine);
+
+    return 0;
+}
@@ -329,6 +329,80 @@ ma_result test_data_converter__resampling_required_input(void)
 
 
 
+/*
+Changing the rate with a resolution of one part per million, which is what duplex drift compensation does, uses an output rate of 1000000.
+Adjusting the timer for the new rate must not overflow with such a large output rate or else the output will jump.
+*/
+ma_result test_data_converter__resampling_rate_change(void)
+{
+    ma_result result;
+    ma_data_converter_config config;
+    ma_data_converter converter;
+    static const ma_uint32 ratesIn[] = { 1003001, 996999, 1000501, 999499, 1004007, 995993 };
+    float input[480];
+    float output[1024];
+    float prevSample = 0;
+    ma_uint32 iBlock;
+    ma_uint32 iFrame;
+
+    printf("Rate Change\n");
+
+    config = ma_data_converter_config_init(ma_format_f32, ma_format_f32, 1, 1, 48000, 48000);
+    config.allowDynamicSampleRate      = MA_TRUE;
+    config.resampling.algorithm        = ma_resample_algorithm_linear;
+    config.resampling.linear.lpfOrder  = 0;
+
+    result = ma_data_converter_init(&config, NULL, &converter);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    /* The input is a ramp so the output of linear interpolation at a ratio close to 1 should always increase by close to 1. */
+    for (iBlock = 0; iBlock < 200; iBlock += 1) {
+        ma_uint64 frameCountIn  = ma_countof(input);
+        ma_uint64 frameCountOut = ma_countof(output);
+
+        for (iFrame = 0; iFrame < ma_countof(input); iFrame += 1) {
+            input[iFrame] = (float)(iBlock * ma_countof(input) + iFrame);
+        }
+
+        ma_data_converter_set_rate(&converter, ratesIn[iBlock % ma_countof(ratesIn)], 1000000);
+
+        result = ma_data_converter_process_pcm_frames(&converter, input, &frameCountIn, output, &frameCountOut);
+        if (result != MA_SUCCESS || frameCountIn != ma_countof(input)) {
+            printf("ERROR: Failed to process block %u.\n", iBlock);
+            result = MA_ERROR;
+            break;
+        }
+
+        for (iFrame = 0; iFrame < frameCountOut; iFrame += 1) {
+            /* The first block is skipped because the resampler needs a frame to prime itself. */
+            if (iBlock > 0 && (output[iFrame] - prevSample < 0.99f || output[iFrame] - prevSample > 1.01f)) {
+                printf("ERROR: Discontinuity in block %u: %f -> %f\n", iBlock, prevSample, output[iFrame]);
+                result = MA_ERROR;
+                break;
+            }
+
+            prevSample = output[iFrame];
+        }
+
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+
+    ma_data_converter_uninit(&converter, NULL);
+
+    if (result != MA_SUCCESS) {
+        printf("FAILED\n");
+    } else {
+        printf("PASSED\n");
+    }
+
+    return result;
+}
+
+
 ma_result test_data_converter__resampling(void)
 {
     ma_result result;
@@ -344,6 +418,11 @@ ma_result test_data_converter__resampling(void)
         hasError = MA_TRUE;
     }
 
+    result = test_data_converter__resampling_rate_change();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
     if (hasError) {
         return MA_ERROR;
     } else {
@@ -352,6 +431,658 @@ ma_result test_data_converter__resampling(void)
 }
 
 
+/*
+Processes the whole input in irregular chunks so the fused and unfused paths are both exercised across chunk boundaries.
+*/
+ma_uint64 test_data_converter__process_in_chunks(ma_data_converter* pConverter, const void* pFramesIn, ma_uint64 frameCountIn, void* pFramesOut, ma_uint64 frameCapacityOut)
+{
+    ma_uint32 bpfIn  = ma_get_bytes_per_frame(pConverter->formatIn,  pConverter->channelsIn);
+    ma_uint32 bpfOut = ma_get_bytes_per_frame(pConverter->formatOut, pConverter->channelsOut);
+    ma_uint64 totalFramesRead = 0;
+    ma_uint64 totalFramesWritten = 0;
+    ma_uint32 lcg = 4321;
+
+    for (;;) {
+        ma_uint64 framesToReadThisIteration;
+        ma_uint64 framesToWriteThisIteration;
+
+        lcg = lcg * 1103515245 + 12345;
+        framesToReadThisIteration  = 1 + ((lcg >> 16) % 700);
+        framesToWriteThisIteration = 1 + ((lcg >>  4) % 900);
+
+        if (framesToReadThisIteration > frameCountIn - totalFramesRead) {
+            framesToReadThisIteration = frameCountIn - totalFramesRead;
+        }
+        if (framesToWriteThisIteration > frameCapacityOut - totalFramesWritten) {
+            framesToWriteThisIteration = frameCapacityOut - totalFramesWritten;
+        }
+
+        if (ma_data_converter_process_pcm_frames(pConverter, ma_offset_ptr(pFramesIn, totalFramesRead * bpfIn), &framesToReadThisIteration, ma_offset_ptr(pFramesOut, totalFramesWritten * bpfOut), &framesToWriteThisIteration) != MA_SUCCESS) {
+            break;
+        }
+
+        totalFramesRead    += framesToReadThisIteration;
+        totalFramesWritten += framesToWriteThisIteration;
+
+        if (framesToReadThisIteration == 0 && framesToWriteThisIteration == 0) {
+            break;
+        }
+    }
+
+    return totalFramesWritten;
+}
+
+/*
+When the first stage is an f32 linear resampler or a mixing channel conversion, the input format conversion is fused into that stage.
+The output must be bit-identical to the unfused path which we get by clearing the fused flags on a second converter.
+*/
+ma_result test_data_converter__fused_input_by_format(ma_format formatIn, ma_format formatOut, ma_uint32 channelsIn, ma_uint32 channelsOut, ma_uint32 sampleRateIn, ma_uint32 sampleRateOut)
+{
+    ma_result result;
+    ma_data_converter_config config;
+    ma_data_converter converterFused;
+    ma_data_converter converterUnfused;
+    ma_uint64 frameCountIn = 4000;
+    ma_uint64 frameCapacityOut = 8192;
+    float* pSourceF32;
+    void* pFramesIn;
+    void* pFramesOutFused;
+    void* pFramesOutUnfused;
+    ma_uint64 framesOutFused;
+    ma_uint64 framesOutUnfused;
+    ma_uint64 iSample;
+    ma_uint32 lcg = 1234;
+
+    config = ma_data_converter_config_init(formatIn, formatOut, channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+    config.resampling.algorithm = ma_resample_algorithm_linear;
+
+    result = ma_data_converter_init(&config, NULL, &converterFused);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    result = ma_data_converter_init(&config, NULL, &converterUnfused);
+    if (result != MA_SUCCESS) {
+        ma_data_converter_uninit(&converterFused, NULL);
+        return result;
+    }
+
+    converterUnfused.hasFusedResamplerInput = MA_FALSE;
+    converterUnfused.hasFusedChannelInput   = MA_FALSE;
+
+    /* Make sure we're actually testing something. A non-f32 input with an f32 mid format must take one of the fused paths. */
+    if (formatIn != ma_format_f32 && ma_data_converter_config_get_mid_format(&config) == ma_format_f32) {
+        if (!converterFused.hasFusedResamplerInput && !converterFused.hasFusedChannelInput) {
+            printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz) did not take a fused path.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+            ma_data_converter_uninit(&converterFused, NULL);
+            ma_data_converter_uninit(&converterUnfused, NULL);
+            return MA_ERROR;
+        }
+    }
+
+    pSourceF32        = (float*)ma_malloc((size_t)(frameCountIn * channelsIn * sizeof(float)), NULL);
+    pFramesIn         = ma_malloc((size_t)(frameCountIn * ma_get_bytes_per_frame(formatIn, channelsIn)), NULL);
+    pFramesOutFused   = ma_malloc((size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)), NULL);
+    pFramesOutUnfused = ma_malloc((size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)), NULL);
+    if (pSourceF32 == NULL || pFramesIn == NULL || pFramesOutFused == NULL || pFramesOutUnfused == NULL) {
+        result = MA_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    /* Noise covers the full range of each format, including the clipping points. */
+    for (iSample = 0; iSample < frameCountIn * channelsIn; iSample += 1) {
+        lcg = lcg * 1103515245 + 12345;
+        pSourceF32[iSample] = ((float)(lcg >> 8) / (float)(1 << 23)) * 2.1f - 1.05f;
+    }
+
+    ma_pcm_convert(pFramesIn, formatIn, pSourceF32, ma_format_f32, frameCountIn * channelsIn, ma_dither_mode_none);
+
+    MA_ZERO_MEMORY(pFramesOutFused,   (size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)));
+    MA_ZERO_MEMORY(pFramesOutUnfused, (size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)));
+
+    framesOutFused   = test_data_converter__process_in_chunks(&converterFused,   pFramesIn, frameCountIn, pFramesOutFused,   frameCapacityOut);
+    framesOutUnfused = test_data_converter__process_in_chunks(&converterUnfused, pFramesIn, frameCountIn, pFramesOutUnfused, frameCapacityOut);
+
+    if (framesOutFused == 0 || framesOutFused != framesOutUnfused) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): frame count mismatch. Fused %u, unfused %u.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut, (ma_uint32)framesOutFused, (ma_uint32)framesOutUnfused);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (memcmp(pFramesOutFused, pFramesOutUnfused, (size_t)(framesOutFused * ma_get_bytes_per_frame(formatOut, channelsOut))) != 0) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): fused output differs from the unfused output.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    result = MA_SUCCESS;
+
+done:
+    ma_free(pSourceF32, NULL);
+    ma_free(pFramesIn, NULL);
+    ma_free(pFramesOutFused, NULL);
+    ma_free(pFramesOutUnfused, NULL);
+    ma_data_converter_uninit(&converterFused, NULL);
+    ma_data_converter_uninit(&converterUnfused, NULL);
+
+    return result;
+}
+
+ma_result test_data_converter__fused_input(void)
+{
+    static const ma_format formats[] = { ma_format_u8, ma_format_s16, ma_format_s24, ma_format_s32, ma_format_f32 };
+    static const ma_uint32 stages[][4] = {
+        /* channelsIn, channelsOut, sampleRateIn, sampleRateOut */
+        { 1, 1, 44100, 48000 },     /* Resample only. */
+        { 2, 2, 48000, 44100 },     /* Resample only, interleaved. */
+        { 2, 1, 48000, 48000 },     /* Mono out. */
+        { 2, 6, 48000, 48000 },     /* Weights (up-mix). */
+        { 6, 2, 48000, 48000 },     /* Weights (down-mix). */
+        { 6, 2, 48000, 44100 }      /* Weights followed by resampling. */
+    };
+    ma_bool32 hasError = MA_FALSE;
+    ma_uint32 iStage;
+    ma_uint32 iFormatIn;
+    ma_uint32 iFormatOut;
+
+    printf("Fused Input Conversion\n");
+
+    for (iStage = 0; iStage < ma_countof(stages); iStage += 1) {
+        for (iFormatIn = 0; iFormatIn < ma_countof(formats); iFormatIn += 1) {
+            for (iFormatOut = 0; iFormatOut < ma_countof(formats); iFormatOut += 1) {
+                if (test_data_converter__fused_input_by_format(formats[iFormatIn], formats[iFormatOut], stages[iStage][0], stages[iStage][1], stages[iStage][2], stages[iStage][3]) != MA_SUCCESS) {
+                    hasError = MA_TRUE;
+                }
+            }
+        }
+    }
+
+    if (hasError) {
+        printf("FAILED\n");
+        return MA_ERROR;
+    } else {
+        printf("PASSED\n");
+        return MA_SUCCESS;
+    }
+}
+
+
+typedef struct
+{
+    ma_uint32 mallocCount;
+} scratch_test_allocation_counter;
+
+static void* scratch_test__malloc(size_t sz, void* pUserData)
+{
+    ((scratch_test_allocation_counter*)pUserData)->mallocCount += 1;
+    return ma_malloc(sz, NULL);
+}
+
+static void* scratch_test__realloc(void* p, size_t sz, void* pUserData)
+{
+    ((scratch_test_allocation_counter*)pUserData)->mallocCount += 1;
+    return ma_realloc(p, sz, NULL);
+}
+
+static void scratch_test__free(void* p, void* pUserData)
+{
+    (void)pUserData;
+    ma_free(p, NULL);
+}
+
+/*
+A converter given a caller owned scratch buffer must use it for its intermediary buffers without allocating anything for it, and the
+output must be the same as with the stack buffers.
+*/
+ma_result test_data_converter__scratch_buffer_by_config(ma_format formatIn, ma_format formatOut, ma_uint32 channelsIn, ma_uint32 channelsOut, ma_uint32 sampleRateIn, ma_uint32 sampleRateOut)
+{
+    ma_result result;
+    ma_data_converter_config config;
+    ma_data_converter converterStack;
+    ma_data_converter converterScratch;
+    scratch_test_allocation_counter counter;
+    ma_allocation_callbacks allocationCallbacks;
+    size_t heapSizeStack;
+    size_t heapSizeScratch;
+    size_t heapSizeOwnedScratch;
+    ma_uint8 scratch[32768];
+    ma_uint64 frameCountIn = 8000;
+    ma_uint64 frameCapacityOut = 16384;
+    void* pFramesIn = NULL;
+    void* pFramesOutStack = NULL;
+    void* pFramesOutScratch = NULL;
+    ma_uint64 framesOutStack;
+    ma_uint64 framesOutScratch;
+    ma_uint32 mallocCountAfterInit;
+    ma_uint64 iSample;
+    size_t iByte;
+    ma_uint32 lcg = 5678;
+
+    MA_ZERO_OBJECT(&counter);
+    allocationCallbacks.pUserData = &counter;
+    allocationCallbacks.onMalloc  = scratch_test__malloc;
+    allocationCallbacks.onRealloc = scratch_test__realloc;
+    allocationCallbacks.onFree    = scratch_test__free;
+
+    config = ma_data_converter_config_init(formatIn, formatOut, channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+    config.resampling.algorithm = ma_resample_algorithm_linear;
+
+    ma_data_converter_get_heap_size(&config, &heapSizeStack);
+
+    result = ma_data_converter_init(&config, NULL, &converterStack);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    /* The scratch buffer is only allocated with the converter when the caller doesn't supply one. */
+    config.pScratchBuffer           = NULL;
+    config.scratchBufferSizeInBytes = sizeof(scratch);
+    ma_data_converter_get_heap_size(&config, &heapSizeOwnedScratch);
+
+    config.pScratchBuffer = scratch;
+    ma_data_converter_get_heap_size(&config, &heapSizeScratch);
+
+    if (heapSizeScratch != heapSizeStack || heapSizeOwnedScratch < heapSizeStack + sizeof(scratch)) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): unexpected heap sizes. %u without a scratch buffer, %u with a caller owned one, %u with an owned one.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut, (ma_uint32)heapSizeStack, (ma_uint32)heapSizeScratch, (ma_uint32)heapSizeOwnedScratch);
+        ma_data_converter_uninit(&converterStack, NULL);
+        return MA_ERROR;
+    }
+
+    result = ma_data_converter_init(&config, &allocationCallbacks, &converterScratch);
+    if (result != MA_SUCCESS) {
+        ma_data_converter_uninit(&converterStack, NULL);
+        return result;
+    }
+
+    mallocCountAfterInit = counter.mallocCount;
+
+    pFramesIn         = ma_malloc((size_t)(frameCountIn * ma_get_bytes_per_frame(formatIn, channelsIn)), NULL);
+    pFramesOutStack   = ma_malloc((size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)), NULL);
+    pFramesOutScratch = ma_malloc((size_t)(frameCapacityOut * ma_get_bytes_per_frame(formatOut, channelsOut)), NULL);
+    if (pFramesIn == NULL || pFramesOutStack == NULL || pFramesOutScratch == NULL) {
+        result = MA_OUT_OF_MEMORY;
+        goto done;
+    }
+
+    for (iSample = 0; iSample < frameCountIn * ma_get_bytes_per_frame(formatIn, channelsIn); iSample += 1) {
+        lcg = lcg * 1103515245 + 12345;
+        ((ma_uint8*)pFramesIn)[iSample] = (ma_uint8)(lcg >> 16);
+    }
+
+    /* If the scratch buffer is used some of this pattern will be overwritten. */
+    MA_ZERO_MEMORY(scratch, sizeof(scratch));
+
+    framesOutStack   = test_data_converter__process_in_chunks(&converterStack,   pFramesIn, frameCountIn, pFramesOutStack,   frameCapacityOut);
+    framesOutScratch = test_data_converter__process_in_chunks(&converterScratch, pFramesIn, frameCountIn, pFramesOutScratch, frameCapacityOut);
+
+    if (counter.mallocCount != mallocCountAfterInit) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): %u allocations while processing.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut, counter.mallocCount - mallocCountAfterInit);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    for (iByte = 0; iByte < sizeof(scratch); iByte += 1) {
+        if (scratch[iByte] != 0) {
+            break;
+        }
+    }
+
+    if (iByte == sizeof(scratch)) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): the scratch buffer was not used.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (framesOutScratch == 0 || framesOutScratch != framesOutStack || memcmp(pFramesOutStack, pFramesOutScratch, (size_t)(framesOutScratch * ma_get_bytes_per_frame(formatOut, channelsOut))) != 0) {
+        printf("ERROR: %s -> %s (%u -> %u channels, %u -> %u Hz): the output with a scratch buffer differs from the output without one.\n", ma_get_format_name(formatIn), ma_get_format_name(formatOut), channelsIn, channelsOut, sampleRateIn, sampleRateOut);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    result = MA_SUCCESS;
+
+done:
+    ma_free(pFramesIn, NULL);
+    ma_free(pFramesOutStack, NULL);
+    ma_free(pFramesOutScratch, NULL);
+    ma_data_converter_uninit(&converterStack, NULL);
+    ma_data_converter_uninit(&converterScratch, &allocationCallbacks);
+
+    return result;
+}
+
+ma_result test_data_converter__scratch_buffer(void)
+{
+    ma_bool32 hasError = MA_FALSE;
+
+    printf("Scratch Buffer\n");
+
+    /* Channel conversion followed by resampling, resampling followed by channel conversion, and format conversion on both sides. */
+    if (test_data_converter__scratch_buffer_by_config(ma_format_s16, ma_format_s16, 6, 2, 48000, 44100) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_data_converter__scratch_buffer_by_config(ma_format_u8, ma_format_s24, 2, 6, 22050, 48000) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_data_converter__scratch_buffer_by_config(ma_format_s32, ma_format_u8, 2, 2, 44100, 48000) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        printf("FAILED\n");
+        return MA_ERROR;
+    } else {
+        printf("PASSED\n");
+        return MA_SUCCESS;
+    }
+}
+
+/*
+Simulates a capture device whose clock runs faster or slower than the playback device by the specified number of parts per million. The
+drift compensation controller should settle on the drift and keep the fill level of the buffer at the target without running dry or
+overflowing.
+*/
+ma_result test_duplex_drift__by_ppm(double driftInPPM)
+{
+    ma_result result;
+    ma_duplex_rb rb;
+    ma_duplex_rb_drift_stats stats;
+    const ma_uint32 sampleRate = 48000;
+    const ma_uint32 periodSizeInFrames = 480;
+    const ma_uint32 periodCount = 100 * 120;   /* 120 seconds. */
+    float output[480];
+    double captureFrames = 0;
+    ma_uint32 capturedFrameCount = 0;
+    ma_uint32 underrunCount = 0;
+    ma_uint32 overrunCount = 0;
+    ma_uint32 maxFillError = 0;
+    ma_uint32 iPeriod;
+
+    printf("    %+d PPM\n", (int)driftInPPM);
+
+    result = ma_duplex_rb_init(ma_format_f32, 1, sampleRate, sampleRate, periodSizeInFrames, NULL, &rb);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    for (iPeriod = 0; iPeriod < periodCount; iPeriod += 1) {
+        ma_uint32 framesToWrite;
+        ma_uint32 framesRead;
+        void* pFramesOut;
+
+        /* The capture side delivers slightly more or less than a period depending on the drift. */
+        captureFrames += periodSizeInFrames * (1 + driftInPPM / 1000000);
+        framesToWrite  = (ma_uint32)(captureFrames - capturedFrameCount);
+        capturedFrameCount += framesToWrite;
+
+        while (framesToWrite > 0) {
+            ma_uint32 framesAcquired = framesToWrite;
+
+            ma_pcm_rb_acquire_write(&rb.rb, &framesAcquired, &pFramesOut);
+            if (framesAcquired == 0) {
+                overrunCount += 1;
+                break;
+            }
+
+            ma_silence_pcm_frames(pFramesOut, framesAcquired, ma_format_f32, 1);
+            ma_pcm_rb_commit_write(&rb.rb, framesAcquired);
+            framesToWrite -= framesAcquired;
+        }
+
+        ma_duplex_rb_read_pcm_frames(&rb, output, periodSizeInFrames, &framesRead);
+        if (framesRead < periodSizeInFrames) {
+            underrunCount += 1;
+        }
+
+        /* Give the controller 30 seconds to settle before checking the fill level. */
+        if (iPeriod > 100 * 30) {
+            ma_duplex_rb_get_drift_stats(&rb, &stats);
+            maxFillError = ma_max(maxFillError, (ma_uint32)ma_abs((ma_int32)stats.averageFillInFrames - (ma_int32)stats.targetFillInFrames));
+        }
+    }
+
+    ma_duplex_rb_get_drift_stats(&rb, &stats);
+    ma_duplex_rb_uninit(&rb);
+
+    printf("      Estimated drift = %f PPM, ratio = %f, max fill error = %u frames\n", stats.driftInPPM, stats.ratio, maxFillError);
+
+    if (ma_abs(stats.driftInPPM - driftInPPM) > ma_abs(driftInPPM) * 0.05) {
+        printf("      Estimated drift is too far from the actual drift.\n");
+        result = MA_ERROR;
+    }
+
+    if (maxFillError > periodSizeInFrames / 4) {
+        printf("      Fill level did not stay near the target.\n");
+        result = MA_ERROR;
+    }
+
+    if (underrunCount > 0 || overrunCount > 0) {
+        printf("      %u underruns, %u overruns.\n", underrunCount, overrunCount);
+        result = MA_ERROR;
+    }
+
+    return result;
+}
+
+int test_entry__duplex_drift(int argc, char** argv)
+{
+    static const double driftsInPPM[] = { 50, -50, 300, -300, 2000, -2000 };
+    ma_bool32 hasError = MA_FALSE;
+    ma_uint32 iDrift;
+
+    (void)argc;
+    (void)argv;
+
+    for (iDrift = 0; iDrift < ma_countof(driftsInPPM); iDrift += 1) {
+        if (test_duplex_drift__by_ppm(driftsInPPM[iDrift]) != MA_SUCCESS) {
+            hasError = MA_TRUE;
+        }
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
+
+
+/*
+Reference implementation of the weights path which runs through every input/output pair of the dense matrix. This is what the
+channel converter did before the weights were compiled into a sparse schedule.
+*/
+void test_channel_converter__process_dense(const ma_channel_converter* pConverter, void* pFramesOut, const void* pFramesIn, ma_uint32 frameCount)
+{
+    ma_uint32 iFrame;
+    ma_uint32 iChannelIn;
+    ma_uint32 iChannelOut;
+
+    MA_ZERO_MEMORY(pFramesOut, frameCount * ma_get_bytes_per_frame(pConverter->format, pConverter->channelsOut));
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        for (iChannelIn = 0; iChannelIn < pConverter->channelsIn; iChannelIn += 1) {
+            for (iChannelOut = 0; iChannelOut < pConverter->channelsOut; iChannelOut += 1) {
+                ma_uint32 iSampleOut = iFrame*pConverter->channelsOut + iChannelOut;
+                ma_uint32 iSampleIn  = iFrame*pConverter->channelsIn  + iChannelIn;
+
+                switch (pConverter->format)
+                {
+                    case ma_format_u8:
+                    {
+                        ma_int16 u8_O = ma_pcm_sample_u8_to_s16_no_scale(((ma_uint8*)pFramesOut)[iSampleOut]);
+                        ma_int16 u8_I = ma_pcm_sample_u8_to_s16_no_scale(((const ma_uint8*)pFramesIn)[iSampleIn]);
+                        ma_int32 s    = (ma_int32)ma_clamp(u8_O + ((u8_I * pConverter->weights.s16[iChannelIn][iChannelOut]) >> MA_CHANNEL_CONVERTER_FIXED_POINT_SHIFT), -128, 127);
+                        ((ma_uint8*)pFramesOut)[iSampleOut] = ma_clip_u8((ma_int16)s);
+                    } break;
+
+                    case ma_format_s16:
+                    {
+                        ma_int32 s = ((ma_int16*)pFramesOut)[iSampleOut];
+                        s += (((const ma_int16*)pFramesIn)[iSampleIn] * pConverter->weights.s16[iChannelIn][iChannelOut]) >> MA_CHANNEL_CONVERTER_FIXED_POINT_SHIFT;
+                        ((ma_int16*)pFramesOut)[iSampleOut] = (ma_int16)ma_clamp(s, -32768, 32767);
+                    } break;
+
+                    case ma_format_s24:
+                    {
+                        ma_int64 s24_O = ma_pcm_sample_s24_to_s32_no_scale(&((ma_uint8*)pFramesOut)[iSampleOut*3]);
+                        ma_int64 s24_I = ma_pcm_sample_s24_to_s32_no_scale(&((const ma_uint8*)pFramesIn)[iSampleIn*3]);
+                        ma_int64 s24   = (ma_int32)ma_clamp(s24_O + ((s24_I * pConverter->weights.s16[iChannelIn][iChannelOut]) >> MA_CHANNEL_CONVERTER_FIXED_POINT_SHIFT), -8388608, 8388607);
+                        ma_pcm_sample_s32_to_s24_no_scale(s24, &((ma_uint8*)pFramesOut)[iSampleOut*3]);
+                    } break;
+
+                    case ma_format_s32:
+                    {
+                        ma_int64 s = ((ma_int32*)pFramesOut)[iSampleOut];
+                        s += ((ma_int64)((const ma_int32*)pFramesIn)[iSampleIn] * pConverter->weights.s16[iChannelIn][iChannelOut]) >> MA_CHANNEL_CONVERTER_FIXED_POINT_SHIFT;
+                        ((ma_int32*)pFramesOut)[iSampleOut] = ma_clip_s32(s);
+                    } break;
+
+                    case ma_format_f32:
+                    {
+                        ((float*)pFramesOut)[iSampleOut] += ((const float*)pFramesIn)[iSampleIn] * pConverter->weights.f32[iChannelIn][iChannelOut];
+                    } break;
+
+                    default: break;
+                }
+            }
+        }
+    }
+}
+
+/*
+Compares the sparse weight schedule against the dense matrix. Integer formats visit the taps in the same order as the dense loop so
+they must match exactly. The f32 SIMD kernels are allowed to differ by rounding.
+*/
+ma_result test_channel_converter__sparse_weights_by_map(ma_format format, ma_standard_channel_map standardChannelMapIn, ma_uint32 channelsIn, ma_standard_channel_map standardChannelMapOut, ma_uint32 channelsOut, ma_bool32* pUsedWeights)
+{
+    ma_result result;
+    ma_channel_converter_config config;
+    ma_channel_converter converter;
+    ma_channel channelMapIn[MA_MAX_CHANNELS];
+    ma_channel channelMapOut[MA_MAX_CHANNELS];
+    ma_uint8 framesIn[257 * 12 * 4];
+    ma_uint8 framesOutSparse[257 * 12 * 4];
+    ma_uint8 framesOutDense[257 * 12 * 4];
+    float framesInF32[257 * 12];
+    ma_uint32 frameCount = 257;    /* Odd so the tails of the SIMD kernels get run. */
+    ma_uint32 iSample;
+    ma_uint32 lcg = 5678;
+
+    *pUsedWeights = MA_FALSE;
+
+    ma_channel_map_init_standard(standardChannelMapIn,  channelMapIn,  ma_countof(channelMapIn),  channelsIn);
+    ma_channel_map_init_standard(standardChannelMapOut, channelMapOut, ma_countof(channelMapOut), channelsOut);
+
+    config = ma_channel_converter_config_init(format, channelsIn, channelMapIn, channelsOut, channelMapOut, ma_channel_mix_mode_rectangular);
+
+    result = ma_channel_converter_init(&config, NULL, &converter);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    if (converter.conversionPath != ma_channel_conversion_path_weights) {
+        ma_channel_converter_uninit(&converter, NULL);
+        return MA_SUCCESS;
+    }
+
+    *pUsedWeights = MA_TRUE;
+
+    /* Loud noise so the integer paths hit their clipping points. */
+    for (iSample = 0; iSample < frameCount * channelsIn; iSample += 1) {
+        lcg = lcg * 1103515245 + 12345;
+        framesInF32[iSample] = ((float)(lcg >> 8) / (float)(1 << 23)) * 2.0f - 1.0f;
+    }
+
+    ma_pcm_convert(framesIn, format, framesInF32, ma_format_f32, frameCount * channelsIn, ma_dither_mode_none);
+
+    result = ma_channel_converter_process_pcm_frames(&converter, framesOutSparse, framesIn, frameCount);
+    if (result != MA_SUCCESS) {
+        ma_channel_converter_uninit(&converter, NULL);
+        return result;
+    }
+
+    test_channel_converter__process_dense(&converter, framesOutDense, framesIn, frameCount);
+
+    if (format == ma_format_f32) {
+        for (iSample = 0; iSample < frameCount * channelsOut; iSample += 1) {
+            float sparse = ((float*)framesOutSparse)[iSample];
+            float dense  = ((float*)framesOutDense )[iSample];
+
+            if (ma_abs(sparse - dense) > 0.000001f) {
+                result = MA_ERROR;
+                break;
+            }
+        }
+    } else {
+        if (memcmp(framesOutSparse, framesOutDense, frameCount * ma_get_bytes_per_frame(format, channelsOut)) != 0) {
+            result = MA_ERROR;
+        }
+    }
+
+    if (result != MA_SUCCESS) {
+        printf("ERROR: %s, %u channels (map %d) -> %u channels (map %d): sparse weights differ from the dense weights.\n", ma_get_format_name(format), channelsIn, (int)standardChannelMapIn, channelsOut, (int)standardChannelMapOut);
+    }
+
+    ma_channel_converter_uninit(&converter, NULL);
+
+    return result;
+}
+
+int test_entry__channel_converter(int argc, char** argv)
+{
+    static const ma_format formats[] = { ma_format_u8, ma_format_s16, ma_format_s24, ma_format_s32, ma_format_f32 };
+    static const ma_uint32 channelCounts[] = { 1, 2, 3, 4, 5, 6, 7, 8, 12 };
+    ma_bool32 hasError = MA_FALSE;
+    ma_uint32 weightsCount = 0;
+    ma_uint32 iFormat;
+    ma_uint32 iMapIn;
+    ma_uint32 iMapOut;
+    ma_uint32 iChannelsIn;
+    ma_uint32 iChannelsOut;
+
+    (void)argc;
+    (void)argv;
+
+    printf("Sparse Weights\n");
+
+    for (iFormat = 0; iFormat < ma_countof(formats); iFormat += 1) {
+        for (iMapIn = ma_standard_channel_map_microsoft; iMapIn <= ma_standard_channel_map_sndio; iMapIn += 1) {
+            for (iMapOut = ma_standard_channel_map_microsoft; iMapOut <= ma_standard_channel_map_sndio; iMapOut += 1) {
+                for (iChannelsIn = 0; iChannelsIn < ma_countof(channelCounts); iChannelsIn += 1) {
+                    for (iChannelsOut = 0; iChannelsOut < ma_countof(channelCounts); iChannelsOut += 1) {
+                        ma_bool32 usedWeights;
+
+                        if (test_channel_converter__sparse_weights_by_map(formats[iFormat], (ma_standard_channel_map)iMapIn, channelCounts[iChannelsIn], (ma_standard_channel_map)iMapOut, channelCounts[iChannelsOut], &usedWeights) != MA_SUCCESS) {
+                            hasError = MA_TRUE;
+                        }
+
+                        if (usedWeights) {
+                            weightsCount += 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /* Make sure the weights path was actually covered. */
+    if (weightsCount == 0) {
+        printf("ERROR: None of the channel maps used the weights path.\n");
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        printf("FAILED\n");
+        return -1;
+    } else {
+        printf("PASSED (%u conversions)\n", weightsCount);
+        return 0;
+    }
+}
+
+
 int test_entry__data_converter(int argc, char** argv)
 {
     ma_result result;
@@ -372,6 +1103,16 @@ int test_entry__data_converter(int argc, char** argv)
         hasError = MA_TRUE;
     }
 
+    result = test_data_converter__fused_input();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_data_converter__scratch_buffer();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
 
     if (hasError) {
         return -1;
@@ -384,7 +1125,9 @@ int test_entry__data_converter(int argc, char** argv)
 
 int main(int argc, char** argv)
 {
+    ma_register_test("Channel Conversion", test_entry__channel_converter);
     ma_register_test("Data Conversion", test_entry__data_converter);
+    ma_register_test("Duplex Drift Compensation", test_entry__duplex_drift);
 
     return ma_run_tests(argc, argv);
 }
@@ -0,0 +1,10 @@
+#include "../common/common.c"
+
+#include "devices_realtime.c"
+
+int main(int argc, char** argv)
+{
+    ma_register_test("Real-Time Audio Thread", test_entry__realtime);
+
+    return ma_run_tests(argc, argv);
+}
@@ -0,0 +1,258 @@
+#if defined(MA_LINUX)
+#include <sys/mman.h>   /* munlockall() */
+#endif
+
+#define REALTIME_TEST_PRIORITY  10
+
+typedef struct
+{
+    MA_ATOMIC(4, ma_uint32) callbackCount;
+#if defined(MA_LINUX)
+    pid_t threadID;
+    int policy;
+    int priority;
+#endif
+} test_realtime_state;
+
+typedef struct
+{
+    ma_uint32 warningCount;
+    ma_bool32 hasRealtimeLine;  /* Posted when SCHED_FIFO was applied. */
+} test_realtime_log;
+
+static void test_realtime_log_callback(void* pUserData, ma_uint32 level, const char* pMessage)
+{
+    test_realtime_log* pCapture = (test_realtime_log*)pUserData;
+
+    if (level == MA_LOG_LEVEL_WARNING) {
+        pCapture->warningCount += 1;
+    }
+
+    if (level == MA_LOG_LEVEL_INFO && strstr(pMessage, "SCHED_FIFO") != NULL) {
+        pCapture->hasRealtimeLine = MA_TRUE;
+    }
+}
+
+static void test_realtime_data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
+{
+    test_realtime_state* pState = (test_realtime_state*)pDevice->pUserData;
+
+    (void)pOutput;
+    (void)pInput;
+    (void)frameCount;
+
+    /* The first callback records what the audio thread looks like. The main thread waits on the count before looking. */
+    if (ma_atomic_load_32(&pState->callbackCount) == 0) {
+    #if defined(MA_LINUX)
+        struct sched_param sched;
+
+        pState->threadID = ma_gettid();
+        if (pthread_getschedparam(pthread_self(), &pState->policy, &sched) == 0) {
+            pState->priority = sched.sched_priority;
+        }
+    #endif
+    }
+
+    ma_atomic_fetch_add_32(&pState->callbackCount, 1);
+}
+
+#if defined(MA_LINUX)
+/* Copies the value of a "key: value" line from a file in /proc. */
+static ma_bool32 test_realtime__read_proc_value(const char* pPath, const char* pKey, char* pValue, size_t valueCap)
+{
+    char line[256];
+    FILE* pFile;
+    ma_bool32 found = MA_FALSE;
+
+    pFile = fopen(pPath, "r");
+    if (pFile == NULL) {
+        return MA_FALSE;
+    }
+
+    while (fgets(line, sizeof(line), pFile) != NULL) {
+        if (strncmp(line, pKey, strlen(pKey)) == 0 && line[strlen(pKey)] == ':') {
+            const char* pValueStart = line + strlen(pKey) + 1;
+            pValueStart += strspn(pValueStart, " \t");
+            ma_strncpy_s(pValue, valueCap, pValueStart, (size_t)-1);
+            pValue[strcspn(pValue, "\n")] = '\0';
+            found = MA_TRUE;
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return found;
+}
+#endif
+
+/*
+Runs a playback device on the null backend, which uses miniaudio's own audio thread, with every real-time setting enabled. Whether
+real-time scheduling and memory locking work depends on the privileges of the process so either the setting must have been applied, or
+a warning must have been posted and the device must still run. Both are checked from the outside on Linux.
+*/
+int test_entry__realtime(int argc, char** argv)
+{
+    ma_result result;
+    ma_log log;
+    test_realtime_log capture;
+    ma_backend backend = ma_backend_null;
+    ma_context_config contextConfig;
+    ma_context context;
+    ma_device_config deviceConfig;
+    ma_device device;
+    ma_node_graph_config nodeGraphConfig;
+    ma_node_graph nodeGraph;
+    ma_engine_config engineConfig;
+    test_realtime_state state;
+    ma_uint32 cpus[1] = { 0 };  /* The only CPU we can rely on existing. */
+    ma_uint32 attempts;
+    int exitCode = -1;
+
+    (void)argc;
+    (void)argv;
+
+    MA_ZERO_OBJECT(&capture);
+    MA_ZERO_OBJECT(&state);
+
+    printf("    Defaults\n");
+    deviceConfig = ma_device_config_init(ma_device_type_playback);
+    if (deviceConfig.realtime.scheduling != ma_device_realtime_scheduling_default || deviceConfig.realtime.priority != 0 || deviceConfig.realtime.pCPUs != NULL || deviceConfig.realtime.cpuCount != 0 || deviceConfig.realtime.lockMemory || deviceConfig.realtime.prefaultStackSizeInBytes != 0) {
+        printf("      Unexpected default real-time settings.\n");
+        return -1;
+    }
+
+    nodeGraphConfig = ma_node_graph_config_init(2);
+    engineConfig    = ma_engine_config_init();
+    if (nodeGraphConfig.prefaultPreMixStack || engineConfig.prefaultPreMixStack) {
+        printf("      The pre-mix stack should not be prefaulted by default.\n");
+        return -1;
+    }
+
+    result = ma_log_init(NULL, &log);
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    ma_log_register_callback(&log, ma_log_callback_init(test_realtime_log_callback, &capture));
+
+    contextConfig = ma_context_config_init();
+    contextConfig.pLog = &log;
+
+    result = ma_context_init(&backend, 1, &contextConfig, &context);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize the null backend. %s\n", ma_result_description(result));
+        ma_log_uninit(&log);
+        return -1;
+    }
+
+    printf("    Invalid CPU lists\n");
+    deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.realtime.pCPUs    = NULL;
+    deviceConfig.realtime.cpuCount = 1;
+
+    if (ma_device_init(&context, &deviceConfig, &device) != MA_INVALID_ARGS) {
+        printf("      A CPU count without a CPU list was accepted.\n");
+        goto done_context;
+    }
+
+    deviceConfig.realtime.pCPUs    = cpus;
+    deviceConfig.realtime.cpuCount = MA_MAX_DEVICE_REALTIME_CPUS + 1;
+
+    if (ma_device_init(&context, &deviceConfig, &device) != MA_INVALID_ARGS) {
+        printf("      More than MA_MAX_DEVICE_REALTIME_CPUS CPUs were accepted.\n");
+        goto done_context;
+    }
+
+    printf("    Real-time device\n");
+    deviceConfig = ma_device_config_init(ma_device_type_playback);
+    deviceConfig.playback.format               = ma_format_f32;
+    deviceConfig.playback.channels             = 2;
+    deviceConfig.sampleRate                    = 48000;
+    deviceConfig.dataCallback                  = test_realtime_data_callback;
+    deviceConfig.pUserData                     = &state;
+    deviceConfig.realtime.scheduling           = ma_device_realtime_scheduling_fifo;
+    deviceConfig.realtime.priority             = REALTIME_TEST_PRIORITY;
+    deviceConfig.realtime.pCPUs                = cpus;
+    deviceConfig.realtime.cpuCount             = ma_countof(cpus);
+    deviceConfig.realtime.lockMemory           = MA_TRUE;
+    deviceConfig.realtime.prefaultStackSizeInBytes = 64 * 1024;
+
+    result = ma_device_init(&context, &deviceConfig, &device);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize device. %s\n", ma_result_description(result));
+        goto done_context;
+    }
+
+    result = ma_device_start(&device);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to start device. %s\n", ma_result_description(result));
+        goto done_device;
+    }
+
+    for (attempts = 0; attempts < 2000 && ma_atomic_load_32(&state.callbackCount) < 5; attempts += 1) {
+        ma_sleep(1);
+    }
+
+    ma_device_stop(&device);
+
+    if (ma_atomic_load_32(&state.callbackCount) < 5) {
+        printf("      The data callback was only fired %u times.\n", ma_atomic_load_32(&state.callbackCount));
+        goto done_device;
+    }
+
+#if defined(MA_LINUX)
+    {
+        char path[256];
+        char value[64] = "";
+
+        if (state.policy == SCHED_FIFO) {
+            if (state.priority != REALTIME_TEST_PRIORITY || !capture.hasRealtimeLine) {
+                printf("      The audio thread has a SCHED_FIFO priority of %d. Expecting %d.\n", state.priority, REALTIME_TEST_PRIORITY);
+                goto done_device;
+            }
+        } else if (capture.warningCount == 0) {
+            printf("      The audio thread is not using SCHED_FIFO but no warning was posted.\n");
+            goto done_device;
+        }
+
+        /* The thread is still alive because the device is only stopped. */
+        sprintf(path, "/proc/self/task/%d/status", (int)state.threadID);
+        if (!test_realtime__read_proc_value(path, "Cpus_allowed_list", value, sizeof(value)) || strcmp(value, "0") != 0) {
+            printf("      The audio thread is allowed to run on CPUs \"%s\". Expecting \"0\".\n", value);
+            goto done_device;
+        }
+
+        if (test_realtime__read_proc_value("/proc/self/status", "VmLck", value, sizeof(value)) && strtoul(value, NULL, 10) == 0 && capture.warningCount == 0) {
+            printf("      No memory is locked but no warning was posted.\n");
+            goto done_device;
+        }
+    }
+#endif
+
+    printf("    Prefaulted pre-mix stack\n");
+    nodeGraphConfig = ma_node_graph_config_init(2);
+    nodeGraphConfig.prefaultPreMixStack = MA_TRUE;
+
+    result = ma_node_graph_init(&nodeGraphConfig, NULL, &nodeGraph);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize a node graph with a prefaulted pre-mix stack. %s\n", ma_result_description(result));
+        goto done_device;
+    }
+
+    ma_node_graph_uninit(&nodeGraph, NULL);
+
+    exitCode = 0;
+
+done_device:
+    ma_device_uninit(&device);
+done_context:
+    ma_context_uninit(&context);
+    ma_log_uninit(&log);
+
+#if defined(MA_LINUX)
+    /* Memory locking applies to the whole process so undo it for any tests that follow. */
+    munlockall();
+#endif
+
+    return exitCode;
+}
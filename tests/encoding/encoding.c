@@ -0,0 +1,11 @@
+#define MA_NO_DEVICE_IO
+#include "../common/common.c"
+
+#include "encoding_flac.c"
+
+int main(int argc, char** argv)
+{
+    ma_register_test("FLAC Round Trip", test_entry__flac_round_trip);
+
+    return ma_run_tests(argc, argv);
+}
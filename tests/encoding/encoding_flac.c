@@ -0,0 +1,304 @@
+/* Not a multiple of any block size so the last block is always a partial one. */
+#define FLAC_TEST_FRAME_COUNT   10007
+#define FLAC_TEST_SAMPLE_RATE   44100
+
+typedef enum
+{
+    flac_test_signal_silence,
+    flac_test_signal_ramp,
+    flac_test_signal_noise
+} flac_test_signal;
+
+static const char* g_flacTestSignalNames[] = { "Silence", "Ramp", "Noise" };
+
+/* The encoder's output is written to memory so it can be decoded straight away. */
+typedef struct
+{
+    ma_uint8* pData;
+    size_t dataSize;
+    size_t dataCap;
+    size_t cursor;
+} flac_test_stream;
+
+static ma_result flac_test_stream__on_write(ma_encoder* pEncoder, const void* pBufferIn, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    flac_test_stream* pStream = (flac_test_stream*)pEncoder->pUserData;
+
+    if (pStream->cursor + bytesToWrite > pStream->dataCap) {
+        size_t newCap = ma_max(pStream->cursor + bytesToWrite, pStream->dataCap * 2);
+        ma_uint8* pNewData = (ma_uint8*)ma_realloc(pStream->pData, newCap, NULL);
+        if (pNewData == NULL) {
+            return MA_OUT_OF_MEMORY;
+        }
+
+        pStream->pData   = pNewData;
+        pStream->dataCap = newCap;
+    }
+
+    MA_COPY_MEMORY(pStream->pData + pStream->cursor, pBufferIn, bytesToWrite);
+    pStream->cursor += bytesToWrite;
+    pStream->dataSize = ma_max(pStream->dataSize, pStream->cursor);
+
+    *pBytesWritten = bytesToWrite;
+    return MA_SUCCESS;
+}
+
+static ma_result flac_test_stream__on_seek(ma_encoder* pEncoder, ma_int64 offset, ma_seek_origin origin)
+{
+    flac_test_stream* pStream = (flac_test_stream*)pEncoder->pUserData;
+    ma_int64 newCursor;
+
+    if (origin == ma_seek_origin_start) {
+        newCursor = offset;
+    } else if (origin == ma_seek_origin_current) {
+        newCursor = (ma_int64)pStream->cursor + offset;
+    } else {
+        newCursor = (ma_int64)pStream->dataSize + offset;
+    }
+
+    if (newCursor < 0 || newCursor > (ma_int64)pStream->dataSize) {
+        return MA_BAD_SEEK;
+    }
+
+    pStream->cursor = (size_t)newCursor;
+    return MA_SUCCESS;
+}
+
+static ma_uint32 flac_test_get_bits_per_sample(ma_format format)
+{
+    return ma_get_bytes_per_sample(format) * 8;
+}
+
+static void flac_test_set_sample(void* pFrames, ma_format format, ma_uint64 sampleIndex, ma_int32 value)
+{
+    switch (format)
+    {
+        case ma_format_u8:
+        {
+            ((ma_uint8*)pFrames)[sampleIndex] = (ma_uint8)(value + 128);
+        } break;
+
+        case ma_format_s16:
+        {
+            ((ma_int16*)pFrames)[sampleIndex] = (ma_int16)value;
+        } break;
+
+        case ma_format_s24:
+        {
+            ma_uint8* pSample = (ma_uint8*)pFrames + sampleIndex*3;
+            pSample[0] = (ma_uint8)((value >>  0) & 0xFF);
+            pSample[1] = (ma_uint8)((value >>  8) & 0xFF);
+            pSample[2] = (ma_uint8)((value >> 16) & 0xFF);
+        } break;
+
+        default: break;
+    }
+}
+
+/* Fills the buffer with a signal that covers the full range of the format. Each channel is offset so they aren't all the same. */
+static void flac_test_generate(void* pFrames, ma_format format, ma_uint32 channels, flac_test_signal signal)
+{
+    ma_uint32 bitsPerSample = flac_test_get_bits_per_sample(format);
+    ma_int32 minValue = -(ma_int32)(1 << (bitsPerSample - 1));
+    ma_uint32 range = (ma_uint32)1 << bitsPerSample;
+    ma_lcg lcg;
+    ma_uint64 iFrame;
+    ma_uint32 iChannel;
+
+    ma_lcg_seed(&lcg, 4321);
+
+    for (iFrame = 0; iFrame < FLAC_TEST_FRAME_COUNT; iFrame += 1) {
+        for (iChannel = 0; iChannel < channels; iChannel += 1) {
+            ma_int32 value = 0;
+
+            if (signal == flac_test_signal_ramp) {
+                value = minValue + (ma_int32)(((iFrame * 97) + (iChannel * (range / 8))) % range);
+            } else if (signal == flac_test_signal_noise) {
+                value = minValue + (ma_int32)((ma_uint32)ma_lcg_rand_s32(&lcg) % range);
+            }
+
+            flac_test_set_sample(pFrames, format, iFrame*channels + iChannel, value);
+        }
+    }
+}
+
+static ma_result flac_test_encode(const void* pFrames, ma_format format, ma_uint32 channels, ma_uint32 compressionLevel, ma_uint32 threadCount, flac_test_stream* pStream)
+{
+    ma_result result;
+    ma_encoder_config encoderConfig;
+    ma_encoder encoder;
+    ma_uint64 framesWritten;
+
+    MA_ZERO_OBJECT(pStream);
+
+    encoderConfig = ma_encoder_config_init(ma_encoding_format_flac, format, channels, FLAC_TEST_SAMPLE_RATE);
+    encoderConfig.flac.compressionLevel = compressionLevel;
+    encoderConfig.flac.threadCount      = threadCount;
+
+    result = ma_encoder_init(flac_test_stream__on_write, flac_test_stream__on_seek, pStream, &encoderConfig, &encoder);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize encoder. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    result = ma_encoder_write_pcm_frames(&encoder, pFrames, FLAC_TEST_FRAME_COUNT, &framesWritten);
+    ma_encoder_uninit(&encoder);
+
+    if (result != MA_SUCCESS || framesWritten != FLAC_TEST_FRAME_COUNT) {
+        printf("      Failed to encode. Wrote %u frames. %s\n", (unsigned int)framesWritten, ma_result_description(result));
+        ma_free(pStream->pData, NULL);
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+/*
+The decoder is asked for s32 because that's lossless for every bit depth. Converting the input to s32 is just a shift so the two can be
+compared bit for bit.
+*/
+static ma_result flac_test_decode_and_compare(const flac_test_stream* pStream, const void* pFrames, ma_format format, ma_uint32 channels)
+{
+    ma_result result;
+    ma_decoder_config decoderConfig;
+    ma_decoder decoder;
+    ma_uint64 length;
+    ma_uint64 framesRead;
+    ma_int32* pExpectedFrames;
+    ma_int32* pDecodedFrames;
+    size_t bytesPerFrame = ma_get_bytes_per_frame(ma_format_s32, channels);
+
+    decoderConfig = ma_decoder_config_init(ma_format_s32, channels, FLAC_TEST_SAMPLE_RATE);
+    decoderConfig.encodingFormat = ma_encoding_format_flac;
+
+    result = ma_decoder_init_memory(pStream->pData, pStream->dataSize, &decoderConfig, &decoder);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize decoder. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    /* The length comes from STREAMINFO which is filled in when the encoder is uninitialized. */
+    result = ma_decoder_get_length_in_pcm_frames(&decoder, &length);
+    if (result != MA_SUCCESS || length != FLAC_TEST_FRAME_COUNT) {
+        printf("      Expecting a length of %u frames. Got %u.\n", (unsigned int)FLAC_TEST_FRAME_COUNT, (unsigned int)length);
+        ma_decoder_uninit(&decoder);
+        return MA_ERROR;
+    }
+
+    /* One more frame than expected so that anything past the end is caught. */
+    pDecodedFrames  = (ma_int32*)ma_malloc((FLAC_TEST_FRAME_COUNT + 1) * bytesPerFrame, NULL);
+    pExpectedFrames = (ma_int32*)ma_malloc(FLAC_TEST_FRAME_COUNT * bytesPerFrame, NULL);
+    if (pDecodedFrames == NULL || pExpectedFrames == NULL) {
+        ma_free(pDecodedFrames, NULL);
+        ma_free(pExpectedFrames, NULL);
+        ma_decoder_uninit(&decoder);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    result = ma_decoder_read_pcm_frames(&decoder, pDecodedFrames, FLAC_TEST_FRAME_COUNT + 1, &framesRead);
+    ma_decoder_uninit(&decoder);
+
+    ma_pcm_convert(pExpectedFrames, ma_format_s32, pFrames, format, FLAC_TEST_FRAME_COUNT * channels, ma_dither_mode_none);
+
+    if (framesRead != FLAC_TEST_FRAME_COUNT) {
+        printf("      Expecting %u decoded frames. Got %u. %s\n", (unsigned int)FLAC_TEST_FRAME_COUNT, (unsigned int)framesRead, ma_result_description(result));
+        result = MA_ERROR;
+    } else if (memcmp(pDecodedFrames, pExpectedFrames, FLAC_TEST_FRAME_COUNT * bytesPerFrame) != 0) {
+        printf("      The decoded audio is not the same as the input.\n");
+        result = MA_ERROR;
+    } else {
+        result = MA_SUCCESS;
+    }
+
+    ma_free(pDecodedFrames, NULL);
+    ma_free(pExpectedFrames, NULL);
+
+    return result;
+}
+
+/*
+Encodes each signal at every supported bit depth and a few channel counts and then decodes it again. FLAC is lossless so the decoded
+audio must be bit for bit the same as the input. Each case is also encoded with several threads which must give the exact same file.
+*/
+ma_result test_flac_round_trip(ma_format format, ma_uint32 channels, flac_test_signal signal)
+{
+    ma_result result;
+    void* pFrames;
+    flac_test_stream stream;
+    flac_test_stream threadedStream;
+    ma_uint32 compressionLevels[] = { 0, 5, 8 };
+    ma_uint32 iLevel;
+
+    printf("    %s, %u-bit, %u channel(s)\n", g_flacTestSignalNames[signal], (unsigned int)flac_test_get_bits_per_sample(format), (unsigned int)channels);
+
+    pFrames = ma_malloc(FLAC_TEST_FRAME_COUNT * ma_get_bytes_per_frame(format, channels), NULL);
+    if (pFrames == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    flac_test_generate(pFrames, format, channels, signal);
+
+    for (iLevel = 0; iLevel < ma_countof(compressionLevels); iLevel += 1) {
+        result = flac_test_encode(pFrames, format, channels, compressionLevels[iLevel], 1, &stream);
+        if (result != MA_SUCCESS) {
+            break;
+        }
+
+        result = flac_test_decode_and_compare(&stream, pFrames, format, channels);
+        if (result != MA_SUCCESS) {
+            printf("      Compression level %u.\n", (unsigned int)compressionLevels[iLevel]);
+            ma_free(stream.pData, NULL);
+            break;
+        }
+
+        result = flac_test_encode(pFrames, format, channels, compressionLevels[iLevel], 3, &threadedStream);
+        if (result != MA_SUCCESS) {
+            ma_free(stream.pData, NULL);
+            break;
+        }
+
+        if (threadedStream.dataSize != stream.dataSize || memcmp(threadedStream.pData, stream.pData, stream.dataSize) != 0) {
+            printf("      Compression level %u is not the same when encoded with 3 threads.\n", (unsigned int)compressionLevels[iLevel]);
+            result = MA_ERROR;
+        }
+
+        ma_free(threadedStream.pData, NULL);
+        ma_free(stream.pData, NULL);
+
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+
+    ma_free(pFrames, NULL);
+    return result;
+}
+
+int test_entry__flac_round_trip(int argc, char** argv)
+{
+    ma_format formats[] = { ma_format_u8, ma_format_s16, ma_format_s24 };
+    ma_uint32 channelCounts[] = { 1, 2, 6 };
+    ma_uint32 iFormat;
+    ma_uint32 iChannelCount;
+    ma_uint32 iSignal;
+    ma_bool32 hasError = MA_FALSE;
+
+    (void)argc;
+    (void)argv;
+
+    for (iSignal = 0; iSignal < ma_countof(g_flacTestSignalNames); iSignal += 1) {
+        for (iFormat = 0; iFormat < ma_countof(formats); iFormat += 1) {
+            for (iChannelCount = 0; iChannelCount < ma_countof(channelCounts); iChannelCount += 1) {
+                if (test_flac_round_trip(formats[iFormat], channelCounts[iChannelCount], (flac_test_signal)iSignal) != MA_SUCCESS) {
+                    hasError = MA_TRUE;
+                }
+            }
+        }
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
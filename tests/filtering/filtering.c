@@ -24,6 +24,19 @@ ma_result filtering_init_decoder_and_encoder(const char* pInputFilePath, const c
     return MA_SUCCESS;
 }
 
+/* Prints a measured value and checks that it is within the tolerance of what's expected. */
+ma_bool32 filtering_check(const char* pName, float value, float expected, float tolerance)
+{
+    printf("    %s: %f (expected %f)\n", pName, value, expected);
+
+    if (!(ma_abs(value - expected) <= tolerance)) {
+        printf("      Incorrect.\n");
+        return MA_FALSE;
+    }
+
+    return MA_TRUE;
+}
+
 #include "filtering_dithering.c"
 #include "filtering_lpf.c"
 #include "filtering_hpf.c"
@@ -32,6 +45,9 @@ ma_result filtering_init_decoder_and_encoder(const char* pInputFilePath, const c
 #include "filtering_peak.c"
 #include "filtering_loshelf.c"
 #include "filtering_hishelf.c"
+#include "filtering_fft.c"
+#include "filtering_loudness.c"
+#include "filtering_dynamics.c"
 
 int main(int argc, char** argv)
 {
@@ -43,6 +59,9 @@ int main(int argc, char** argv)
     ma_register_test("Peaking EQ Filtering", test_entry__peak);
     ma_register_test("Low Shelf Filtering",  test_entry__loshelf);
     ma_register_test("High Shelf Filtering", test_entry__hishelf);
+    ma_register_test("FFT",                  test_entry__fft);
+    ma_register_test("Loudness Metering",    test_entry__loudness);
+    ma_register_test("Dynamics Processing",  test_entry__dynamics);
 
     return ma_run_tests(argc, argv);
 }
@@ -0,0 +1,237 @@
+static float test_dynamics__run_square(ma_dynamics_mode mode, float thresholdInDB, float inputInDB, float sidechainInDB)
+{
+    ma_dynamics_config config;
+    ma_dynamics dynamics;
+    float input[4800];
+    float sidechain[4800];
+    float output[4800];
+    float amplitude = ma_volume_db_to_linear(inputInDB);
+    ma_uint32 iFrame;
+    ma_uint32 iBlock;
+
+    config = ma_dynamics_config_init(mode, 1, 48000, thresholdInDB);
+    config.sidechainChannels = (sidechainInDB != 0) ? 1 : 0;
+
+    if (ma_dynamics_init(&config, NULL, &dynamics) != MA_SUCCESS) {
+        return 0;
+    }
+
+    for (iFrame = 0; iFrame < ma_countof(input); iFrame += 1) {
+        input[iFrame]     = (iFrame & 1) ? amplitude : -amplitude;
+        sidechain[iFrame] = ma_volume_db_to_linear(sidechainInDB);
+    }
+
+    /* One second to settle. */
+    for (iBlock = 0; iBlock < 10; iBlock += 1) {
+        ma_dynamics_process_pcm_frames(&dynamics, output, input, (sidechainInDB != 0) ? sidechain : NULL, ma_countof(input));
+    }
+
+    ma_dynamics_uninit(&dynamics, NULL);
+
+    return ma_volume_linear_to_db(ma_abs(output[ma_countof(output) - 1]));
+}
+
+int test_entry__dynamics(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_dynamics_config config;
+    ma_dynamics dynamics;
+    float* pInput;
+    float* pOutput;
+    float ceiling = ma_volume_db_to_linear(-6);
+    float peak = 0;
+    ma_uint32 frameCount = 48000;
+    ma_uint32 latency;
+    ma_uint32 iFrame;
+    ma_uint32 framesProcessed;
+
+    (void)argc;
+    (void)argv;
+
+    /* Static curves. Above the knee a compressor with a ratio of 4 turns 14 dB over the threshold into 3.5 dB. */
+    hasError |= !filtering_check("Compressor", test_dynamics__run_square(ma_dynamics_mode_compressor, -20,  -6, 0), -16.5f, 0.05f);
+    hasError |= !filtering_check("Expander",   test_dynamics__run_square(ma_dynamics_mode_expander,   -40, -50, 0), -60.0f, 0.05f);
+    hasError |= !filtering_check("Sidechain",  test_dynamics__run_square(ma_dynamics_mode_compressor, -30, -20, -6), -38.0f, 0.05f);
+
+
+    /* The limiter must never let anything over the threshold, including a single sample spike. */
+    pInput  = (float*)ma_malloc(sizeof(float) * frameCount * 2 * 2, NULL);
+    if (pInput == NULL) {
+        return -1;
+    }
+
+    pOutput = pInput + frameCount * 2;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        float x = (float)ma_sind(iFrame * 0.05) * (((iFrame % 9000) < 4000) ? 1.5f : 0.2f);
+        if (iFrame == 20000) {
+            x = 4;
+        }
+
+        pInput[iFrame*2 + 0] = x;
+        pInput[iFrame*2 + 1] = x * -0.7f;
+    }
+
+    config = ma_dynamics_config_init(ma_dynamics_mode_limiter, 2, 48000, -6);
+    config.releaseTimeInMilliseconds = 10;
+
+    result = ma_dynamics_init(&config, NULL, &dynamics);
+    if (result != MA_SUCCESS) {
+        ma_free(pInput, NULL);
+        return -1;
+    }
+
+    latency = ma_dynamics_get_latency(&dynamics);
+
+    /* Odd sized chunks to make sure the look-ahead buffer wraps properly. */
+    for (framesProcessed = 0; framesProcessed < frameCount; framesProcessed += 333) {
+        ma_dynamics_process_pcm_frames(&dynamics, pOutput + framesProcessed*2, pInput + framesProcessed*2, NULL, ma_min(333, frameCount - framesProcessed));
+    }
+
+    for (iFrame = 0; iFrame < frameCount * 2; iFrame += 1) {
+        peak = ma_max(peak, ma_abs(pOutput[iFrame]));
+    }
+
+    hasError |= !filtering_check("Limiter latency", (float)latency, 240, 0);
+    hasError |= !filtering_check("Limiter peak", peak, ceiling, 0.000001f);
+
+    /* The quiet sections should recover back to unity gain. */
+    hasError |= !filtering_check("Limiter recovery", pOutput[(8000 + latency)*2], pInput[8000*2], 0.0001f);
+
+    ma_dynamics_uninit(&dynamics, NULL);
+
+
+    /* Makeup gain is applied before limiting so it can't push the output over the threshold. The quiet sections are still boosted. */
+    config.makeupGainInDB = 6;
+
+    result = ma_dynamics_init(&config, NULL, &dynamics);
+    if (result != MA_SUCCESS) {
+        ma_free(pInput, NULL);
+        return -1;
+    }
+
+    for (framesProcessed = 0; framesProcessed < frameCount; framesProcessed += 333) {
+        ma_dynamics_process_pcm_frames(&dynamics, pOutput + framesProcessed*2, pInput + framesProcessed*2, NULL, ma_min(333, frameCount - framesProcessed));
+    }
+
+    peak = 0;
+    for (iFrame = 0; iFrame < frameCount * 2; iFrame += 1) {
+        peak = ma_max(peak, ma_abs(pOutput[iFrame]));
+    }
+
+    hasError |= !filtering_check("Limiter peak with makeup gain", peak, ceiling, 0.000001f);
+    hasError |= !filtering_check("Limiter makeup gain", pOutput[(8000 + latency)*2], pInput[8000*2] * ma_volume_db_to_linear(6), 0.0001f);
+
+    ma_dynamics_uninit(&dynamics, NULL);
+
+
+    /* Ducking is limited to the maximum gain reduction, and recovers when the sidechain goes silent. */
+    {
+        ma_ducker_config duckerConfig;
+        ma_ducker ducker;
+        ma_uint32 iBlock;
+
+        duckerConfig = ma_ducker_config_init(48000, -30);
+        result = ma_ducker_init(&duckerConfig, &ducker);
+        if (result != MA_SUCCESS) {
+            ma_free(pInput, NULL);
+            return -1;
+        }
+
+        for (iBlock = 0; iBlock < 4; iBlock += 1) {
+            ma_ducker_process_sidechain_pcm_frames(&ducker, pInput, 4000, 2);
+        }
+
+        hasError |= !filtering_check("Ducker gain reduction", ma_volume_linear_to_db(ma_ducker_get_gain(&ducker)), -12, 0.05f);
+
+        ma_ducker_process_sidechain_pcm_frames(&ducker, NULL, 48000 * 10, 2);
+        hasError |= !filtering_check("Ducker recovery", ma_ducker_get_gain(&ducker), 1, 0);
+    }
+
+    /* When the sidechain of a ducker in an engine is stopped the ducked sounds need to release the ducker themselves. */
+    {
+        ma_engine_config engineConfig;
+        ma_engine engine;
+        ma_waveform_config waveformConfig;
+        ma_waveform sidechainWaveform;
+        ma_waveform targetWaveform;
+        ma_sound sidechainSound;
+        ma_sound targetSound;
+        ma_ducker_config duckerConfig;
+        ma_ducker ducker;
+        float frames[480 * 2];
+        ma_uint32 iPeriod;
+
+        engineConfig = ma_engine_config_init();
+        engineConfig.noDevice   = MA_TRUE;
+        engineConfig.channels   = 2;
+        engineConfig.sampleRate = 48000;
+
+        result = ma_engine_init(&engineConfig, &engine);
+        if (result != MA_SUCCESS) {
+            ma_free(pInput, NULL);
+            return -1;
+        }
+
+        waveformConfig = ma_waveform_config_init(ma_format_f32, 2, 48000, ma_waveform_type_sine, 0.5, 440);
+        ma_waveform_init(&waveformConfig, &sidechainWaveform);
+        ma_waveform_init(&waveformConfig, &targetWaveform);
+
+        duckerConfig = ma_ducker_config_init(48000, -30);
+        ma_ducker_init(&duckerConfig, &ducker);
+
+        ma_sound_init_from_data_source(&engine, &sidechainWaveform, MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, &sidechainSound);
+        ma_sound_init_from_data_source(&engine, &targetWaveform,    MA_SOUND_FLAG_NO_SPATIALIZATION, NULL, &targetSound);
+        ma_sound_set_ducker_sidechain(&sidechainSound, &ducker);
+        ma_sound_set_ducker(&targetSound, &ducker);
+        ma_sound_start(&sidechainSound);
+        ma_sound_start(&targetSound);
+
+        for (iPeriod = 0; iPeriod < 100; iPeriod += 1) {
+            ma_engine_read_pcm_frames(&engine, frames, 480, NULL);
+        }
+
+        hasError |= !filtering_check("Engine ducker gain reduction", ma_volume_linear_to_db(ma_ducker_get_gain(&ducker)), -12, 1);
+
+        /* With the sidechain stopped the gain should recover just like it would with silence. */
+        ma_sound_stop(&sidechainSound);
+
+        for (iPeriod = 0; iPeriod < 1000; iPeriod += 1) {
+            ma_engine_read_pcm_frames(&engine, frames, 480, NULL);
+        }
+
+        hasError |= !filtering_check("Engine ducker recovery after stopping the sidechain", ma_volume_linear_to_db(ma_ducker_get_gain(&ducker)), 0, 0);
+        hasError |= !filtering_check("Engine ducked sound recovery", ma_volume_linear_to_db(targetSound.engineNode.duckingGain), 0, 0);
+
+        /* Moving the engine's time backwards must not stop the ducked sounds from releasing the ducker. */
+        ma_sound_start(&sidechainSound);
+
+        for (iPeriod = 0; iPeriod < 100; iPeriod += 1) {
+            ma_engine_read_pcm_frames(&engine, frames, 480, NULL);
+        }
+
+        ma_engine_set_time_in_pcm_frames(&engine, 0);
+        ma_sound_stop(&sidechainSound);
+
+        for (iPeriod = 0; iPeriod < 1000; iPeriod += 1) {
+            ma_engine_read_pcm_frames(&engine, frames, 480, NULL);
+        }
+
+        hasError |= !filtering_check("Engine ducker recovery after moving the time backwards", ma_volume_linear_to_db(ma_ducker_get_gain(&ducker)), 0, 0);
+
+        ma_sound_uninit(&sidechainSound);
+        ma_sound_uninit(&targetSound);
+        ma_waveform_uninit(&sidechainWaveform);
+        ma_waveform_uninit(&targetWaveform);
+        ma_engine_uninit(&engine);
+    }
+
+    ma_free(pInput, NULL);
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
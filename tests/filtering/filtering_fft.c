@@ -0,0 +1,133 @@
+ma_result test_fft__by_size(ma_uint32 size)
+{
+    ma_result result;
+    ma_fft_config fftConfig;
+    ma_fft fft;
+    float* pSamples;
+    float* pSpectrum;
+    float* pOutput;
+    ma_uint32 i;
+    ma_uint32 k;
+    double maxError = 0;
+    double tolerance = 1e-6 * size;
+
+    printf("    %u\n", size);
+
+    fftConfig = ma_fft_config_init(size);
+    result = ma_fft_init(&fftConfig, NULL, &fft);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    pSamples  = (float*)ma_malloc(sizeof(float) * size * 3, NULL);
+    if (pSamples == NULL) {
+        ma_fft_uninit(&fft, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    pSpectrum = pSamples  + size;
+    pOutput   = pSpectrum + size;
+
+    for (i = 0; i < size; i += 1) {
+        pSamples[i] = (float)ma_sind(i * 0.37) + (float)((i * 7919) % 101) / 101.0f - 0.5f;
+    }
+
+    /* Compare against a direct DFT. */
+    ma_fft_forward(&fft, pSpectrum, pSamples);
+
+    for (k = 0; k <= size/2; k += 1) {
+        double re = 0;
+        double im = 0;
+        double fftRe;
+        double fftIm;
+
+        for (i = 0; i < size; i += 1) {
+            double a = 2 * MA_PI_D * (double)((k * i) % size) / size;
+            re += pSamples[i] * ma_cosd(a);
+            im -= pSamples[i] * ma_sind(a);
+        }
+
+        if (k == 0) {
+            fftRe = pSpectrum[0];
+            fftIm = 0;
+        } else if (k == size/2) {
+            fftRe = pSpectrum[1];
+            fftIm = 0;
+        } else {
+            fftRe = pSpectrum[k*2 + 0];
+            fftIm = pSpectrum[k*2 + 1];
+        }
+
+        maxError = ma_max(maxError, ma_abs(fftRe - re));
+        maxError = ma_max(maxError, ma_abs(fftIm - im));
+    }
+
+    if (maxError > tolerance) {
+        printf("      Forward transform does not match the DFT. Error = %f\n", maxError);
+        result = MA_ERROR;
+    }
+
+    /* In-place must give the same result as out-of-place. */
+    MA_COPY_MEMORY(pOutput, pSamples, sizeof(float) * size);
+    ma_fft_forward(&fft, pOutput, pOutput);
+
+    for (i = 0; i < size; i += 1) {
+        if (pOutput[i] != pSpectrum[i]) {
+            printf("      In-place forward transform does not match.\n");
+            result = MA_ERROR;
+            break;
+        }
+    }
+
+    /* The inverse is not normalized. */
+    ma_fft_inverse(&fft, pSpectrum, pSpectrum);
+
+    maxError = 0;
+    for (i = 0; i < size; i += 1) {
+        maxError = ma_max(maxError, ma_abs(pSpectrum[i] / size - pSamples[i]));
+    }
+
+    if (maxError > 1e-5) {
+        printf("      Round trip does not match the input. Error = %f\n", maxError);
+        result = MA_ERROR;
+    }
+
+    ma_free(pSamples, NULL);
+    ma_fft_uninit(&fft, NULL);
+
+    return result;
+}
+
+int test_entry__fft(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_uint32 size;
+    ma_fft_config fftConfig;
+    ma_fft fft;
+
+    (void)argc;
+    (void)argv;
+
+    /* Odd and even numbers of radix-2 passes need to be tested. */
+    for (size = 4; size <= 4096; size *= 2) {
+        result = test_fft__by_size(size);
+        if (result != MA_SUCCESS) {
+            hasError = MA_TRUE;
+        }
+    }
+
+    /* Sizes that aren't a power of 2 are not supported. */
+    fftConfig = ma_fft_config_init(48);
+    if (ma_fft_init(&fftConfig, NULL, &fft) == MA_SUCCESS) {
+        printf("    Initialization with a size of 48 should have failed.\n");
+        ma_fft_uninit(&fft, NULL);
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
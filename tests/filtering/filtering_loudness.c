@@ -0,0 +1,92 @@
+static void test_loudness__process_sine(ma_loudness_meter* pMeter, ma_uint32 channels, ma_uint32 sampleRate, double frequency, double amplitude, double phase, double durationInSeconds, ma_uint64* pCursor)
+{
+    float frames[480 * 2];
+    ma_uint64 frameCount = (ma_uint64)(durationInSeconds * sampleRate);
+    ma_uint64 totalFramesProcessed = 0;
+
+    MA_ASSERT(channels <= 2);
+
+    while (totalFramesProcessed < frameCount) {
+        ma_uint32 framesToProcess = 480;
+        ma_uint32 iFrame;
+        ma_uint32 iChannel;
+
+        if (framesToProcess > frameCount - totalFramesProcessed) {
+            framesToProcess = (ma_uint32)(frameCount - totalFramesProcessed);
+        }
+
+        for (iFrame = 0; iFrame < framesToProcess; iFrame += 1) {
+            float x = (float)(amplitude * ma_sind(2 * MA_PI_D * frequency * (double)(*pCursor + iFrame) / sampleRate + phase));
+
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                frames[iFrame*channels + iChannel] = x;
+            }
+        }
+
+        ma_loudness_meter_process_pcm_frames(pMeter, frames, framesToProcess);
+
+        *pCursor             += framesToProcess;
+        totalFramesProcessed += framesToProcess;
+    }
+}
+
+int test_entry__loudness(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_loudness_meter_config meterConfig;
+    ma_loudness_meter meter;
+    ma_uint64 cursor;
+    double amplitude23 = ma_powd(10, -23.0 / 20);
+    double amplitude36 = ma_powd(10, -36.0 / 20);
+
+    (void)argc;
+    (void)argv;
+
+    /* A stereo 1 kHz sine with a peak of -23 dBFS reads -23 LUFS. */
+    meterConfig = ma_loudness_meter_config_init(2, 48000);
+    result = ma_loudness_meter_init(&meterConfig, NULL, &meter);
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    cursor = 0;
+    test_loudness__process_sine(&meter, 2, 48000, 1000, amplitude23, 0, 20, &cursor);
+
+    hasError |= !filtering_check("Momentary",  ma_loudness_meter_get_momentary_loudness(&meter),  -23, 0.1f);
+    hasError |= !filtering_check("Short-term", ma_loudness_meter_get_short_term_loudness(&meter), -23, 0.1f);
+    hasError |= !filtering_check("Integrated", ma_loudness_meter_get_integrated_loudness(&meter), -23, 0.1f);
+
+    /* The quiet parts on either side are removed by the relative gate. */
+    ma_loudness_meter_reset(&meter);
+
+    test_loudness__process_sine(&meter, 2, 48000, 1000, amplitude36, 0, 10, &cursor);
+    test_loudness__process_sine(&meter, 2, 48000, 1000, amplitude23, 0, 60, &cursor);
+    test_loudness__process_sine(&meter, 2, 48000, 1000, amplitude36, 0, 10, &cursor);
+
+    hasError |= !filtering_check("Gated integrated", ma_loudness_meter_get_integrated_loudness(&meter), -23, 0.1f);
+
+    ma_loudness_meter_uninit(&meter, NULL);
+
+
+    /* The samples of a 12 kHz sine at 48 kHz with a 45 degree phase never get above -9 dBFS, but the true peak is -6 dBTP. */
+    meterConfig = ma_loudness_meter_config_init(1, 48000);
+    result = ma_loudness_meter_init(&meterConfig, NULL, &meter);
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    cursor = 0;
+    test_loudness__process_sine(&meter, 1, 48000, 12000, 0.5, MA_PI_D / 4, 1, &cursor);
+
+    hasError |= !filtering_check("True peak", ma_loudness_meter_get_true_peak(&meter), -6.02f, 0.3f);
+
+    ma_loudness_meter_uninit(&meter, NULL);
+
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
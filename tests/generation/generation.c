@@ -3,11 +3,13 @@
 
 #include "generation_noise.c"
 #include "generation_waveform.c"
+#include "generation_oscillator_bank.c"
 
 int main(int argc, char** argv)
 {
-    ma_register_test("Noise",    test_entry__noise);
-    ma_register_test("Waveform", test_entry__waveform);
+    ma_register_test("Noise",           test_entry__noise);
+    ma_register_test("Waveform",        test_entry__waveform);
+    ma_register_test("Oscillator Bank", test_entry__oscillator_bank);
 
     return ma_run_tests(argc, argv);
 }
@@ -116,6 +116,83 @@ ma_result test_noise__u8()
     }
 }
 
+ma_result test_noise__seed_by_type(ma_noise_type type)
+{
+    ma_result result;
+    ma_noise_config noiseConfig;
+    ma_noise noise[2];
+    float frames[2][4096];
+    ma_uint32 iRun;
+    ma_uint32 iSample;
+
+    /*
+    Two noise generators with the same seed must give the same output. The second one is read in odd sized pieces which
+    covers the edges of the bulk generation paths.
+    */
+    noiseConfig = ma_noise_config_init(ma_format_f32, 2, type, 1234, 0.5);
+
+    for (iRun = 0; iRun < 2; iRun += 1) {
+        ma_uint32 framesRead = 0;
+
+        result = ma_noise_init(&noiseConfig, NULL, &noise[iRun]);
+        if (result != MA_SUCCESS) {
+            if (iRun > 0) {
+                ma_noise_uninit(&noise[0], NULL);
+            }
+            return result;
+        }
+
+        while (framesRead < 2048) {
+            ma_uint32 framesToRead = (iRun == 0) ? 2048 : ma_min(2048 - framesRead, 37);
+            ma_noise_read_pcm_frames(&noise[iRun], frames[iRun] + framesRead*2, framesToRead, NULL);
+            framesRead += framesToRead;
+        }
+    }
+
+    for (iSample = 0; iSample < 4096; iSample += 1) {
+        if (frames[0][iSample] != frames[1][iSample]) {
+            printf("    Output differs at sample %u.\n", iSample);
+            result = MA_ERROR;
+            break;
+        }
+
+        if (type == ma_noise_type_white && (frames[0][iSample] < 0 || frames[0][iSample] >= 0.5f)) {
+            printf("    White noise out of range at sample %u: %f\n", iSample, frames[0][iSample]);
+            result = MA_ERROR;
+            break;
+        }
+    }
+
+    ma_noise_uninit(&noise[0], NULL);
+    ma_noise_uninit(&noise[1], NULL);
+    return result;
+}
+
+ma_result test_noise__seed()
+{
+    ma_bool32 hasError = MA_FALSE;
+
+    printf("    Seed\n");
+
+    if (test_noise__seed_by_type(ma_noise_type_white) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_noise__seed_by_type(ma_noise_type_pink) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_noise__seed_by_type(ma_noise_type_brownian) != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        return MA_ERROR;
+    } else {
+        return MA_SUCCESS;
+    }
+}
+
 int test_entry__noise(int argc, char** argv)
 {
     ma_result result;
@@ -139,6 +216,11 @@ int test_entry__noise(int argc, char** argv)
         hasError = MA_TRUE;
     }
 
+    result = test_noise__seed();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
     if (hasError) {
         return -1;
     } else {
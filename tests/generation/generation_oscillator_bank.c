@@ -0,0 +1,229 @@
+
+#define TEST_OSCILLATOR_BANK_FRAME_COUNT    4800
+#define TEST_OSCILLATOR_BANK_SAMPLE_RATE    48000
+
+static double test_oscillator_bank__reference(ma_waveform_type type, double t)
+{
+    switch (type)
+    {
+        case ma_waveform_type_sine:     return ma_sind(MA_TAU_D * t);
+        case ma_waveform_type_triangle: return ma_abs(4*t - 2) - 1;
+        case ma_waveform_type_sawtooth: return 2*t - 1;
+        default: return 0;
+    }
+}
+
+static double test_oscillator_bank__measure_aliasing(const float* pSamples, ma_uint32 count, double frequency)
+{
+    /*
+    Removes the DC offset and every harmonic below Nyquist with a least squares fit and returns the RMS
+    of what's left, which is the aliasing.
+    */
+    double* pResidual;
+    double rms = 0;
+    double mean = 0;
+    ma_uint32 i;
+    ma_uint32 k;
+
+    pResidual = (double*)ma_malloc(sizeof(double) * count, NULL);
+    if (pResidual == NULL) {
+        return 1;
+    }
+
+    for (i = 0; i < count; i += 1) {
+        pResidual[i] = pSamples[i];
+    }
+
+    for (k = 1; k*frequency < TEST_OSCILLATOR_BANK_SAMPLE_RATE/2; k += 1) {
+        double w = MA_TAU_D * k * frequency / TEST_OSCILLATOR_BANK_SAMPLE_RATE;
+        double a = 0;
+        double b = 0;
+
+        for (i = 0; i < count; i += 1) {
+            a += pResidual[i] * ma_cosd(w * i);
+            b += pResidual[i] * ma_sind(w * i);
+        }
+
+        a = a * 2 / count;
+        b = b * 2 / count;
+
+        for (i = 0; i < count; i += 1) {
+            pResidual[i] -= a * ma_cosd(w * i) + b * ma_sind(w * i);
+        }
+    }
+
+    for (i = 0; i < count; i += 1) {
+        mean += pResidual[i];
+    }
+    mean /= count;
+
+    for (i = 0; i < count; i += 1) {
+        rms += (pResidual[i] - mean) * (pResidual[i] - mean);
+    }
+
+    ma_free(pResidual, NULL);
+
+    return ma_sqrtd(rms / count);
+}
+
+ma_result test_oscillator_bank__accuracy()
+{
+    ma_result result = MA_SUCCESS;
+    ma_oscillator_bank_config bankConfig;
+    ma_oscillator_bank bank;
+    ma_waveform_type types[3] = { ma_waveform_type_sine, ma_waveform_type_triangle, ma_waveform_type_sawtooth };
+    double frequencies[3] = { 17.3, 440, 5123.7 };
+    float* pOutputs[9];
+    float* pMix;
+    ma_uint32 iOscillator;
+    ma_uint32 iFrame;
+
+    printf("    Accuracy\n");
+
+    bankConfig = ma_oscillator_bank_config_init(9, TEST_OSCILLATOR_BANK_SAMPLE_RATE);
+    if (ma_oscillator_bank_init(&bankConfig, NULL, &bank) != MA_SUCCESS) {
+        return MA_ERROR;
+    }
+
+    pMix = (float*)ma_malloc(sizeof(float) * TEST_OSCILLATOR_BANK_FRAME_COUNT * 10, NULL);
+    if (pMix == NULL) {
+        ma_oscillator_bank_uninit(&bank, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    for (iOscillator = 0; iOscillator < 9; iOscillator += 1) {
+        ma_oscillator_bank_set_oscillator(&bank, iOscillator, types[iOscillator / 3], 0.5, frequencies[iOscillator % 3]);
+        pOutputs[iOscillator] = pMix + TEST_OSCILLATOR_BANK_FRAME_COUNT * (iOscillator + 1);
+    }
+
+    /* An odd frame count so the SIMD and scalar paths are both used. */
+    ma_oscillator_bank_process_pcm_frames(&bank, pOutputs, TEST_OSCILLATOR_BANK_FRAME_COUNT - 1);
+
+    for (iOscillator = 0; iOscillator < 9 && result == MA_SUCCESS; iOscillator += 1) {
+        double advance = frequencies[iOscillator % 3] / TEST_OSCILLATOR_BANK_SAMPLE_RATE;
+
+        for (iFrame = 0; iFrame < TEST_OSCILLATOR_BANK_FRAME_COUNT - 1; iFrame += 1) {
+            double t = advance * iFrame - (ma_int64)(advance * iFrame);
+            double expected;
+
+            /* The sawtooth can land either side of the wrap depending on rounding. */
+            if (t < 1e-6 || t > 1 - 1e-6) {
+                continue;
+            }
+
+            expected = 0.5 * test_oscillator_bank__reference(types[iOscillator / 3], t);
+
+            if (ma_abs(expected - pOutputs[iOscillator][iFrame]) > 1e-5) {
+                printf("      Oscillator %u does not match the reference at frame %u. Expected %f, got %f.\n", iOscillator, iFrame, expected, pOutputs[iOscillator][iFrame]);
+                result = MA_ERROR;
+                break;
+            }
+        }
+    }
+
+    /* Mixing must give the same result as adding each oscillator together. */
+    for (iOscillator = 0; iOscillator < 9; iOscillator += 1) {
+        ma_oscillator_bank_set_phase(&bank, iOscillator, 0);
+    }
+
+    MA_ZERO_MEMORY(pMix, sizeof(float) * TEST_OSCILLATOR_BANK_FRAME_COUNT);
+    ma_oscillator_bank_mix_pcm_frames(&bank, pMix, TEST_OSCILLATOR_BANK_FRAME_COUNT - 1);
+
+    for (iFrame = 0; iFrame < TEST_OSCILLATOR_BANK_FRAME_COUNT - 1; iFrame += 1) {
+        float sum = 0;
+
+        for (iOscillator = 0; iOscillator < 9; iOscillator += 1) {
+            sum += pOutputs[iOscillator][iFrame];
+        }
+
+        if (ma_abs(sum - pMix[iFrame]) > 1e-5f) {
+            printf("      Mixed output does not match at frame %u.\n", iFrame);
+            result = MA_ERROR;
+            break;
+        }
+    }
+
+    ma_free(pMix, NULL);
+    ma_oscillator_bank_uninit(&bank, NULL);
+
+    return result;
+}
+
+ma_result test_oscillator_bank__aliasing()
+{
+    ma_result result = MA_SUCCESS;
+    ma_oscillator_bank_config bankConfig;
+    ma_oscillator_bank bank;
+    ma_waveform_type types[6] = {
+        ma_waveform_type_square,   ma_waveform_type_square_bandlimited,
+        ma_waveform_type_triangle, ma_waveform_type_triangle_bandlimited,
+        ma_waveform_type_sawtooth, ma_waveform_type_sawtooth_bandlimited
+    };
+    float* pOutputs[6];
+    float* pBuffer;
+    ma_uint32 iOscillator;
+    double frequency = 5123.7;
+
+    printf("    Aliasing\n");
+
+    bankConfig = ma_oscillator_bank_config_init(6, TEST_OSCILLATOR_BANK_SAMPLE_RATE);
+    if (ma_oscillator_bank_init(&bankConfig, NULL, &bank) != MA_SUCCESS) {
+        return MA_ERROR;
+    }
+
+    pBuffer = (float*)ma_malloc(sizeof(float) * TEST_OSCILLATOR_BANK_FRAME_COUNT * 6, NULL);
+    if (pBuffer == NULL) {
+        ma_oscillator_bank_uninit(&bank, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    for (iOscillator = 0; iOscillator < 6; iOscillator += 1) {
+        ma_oscillator_bank_set_oscillator(&bank, iOscillator, types[iOscillator], 1, frequency);
+        pOutputs[iOscillator] = pBuffer + TEST_OSCILLATOR_BANK_FRAME_COUNT * iOscillator;
+    }
+
+    ma_oscillator_bank_process_pcm_frames(&bank, pOutputs, TEST_OSCILLATOR_BANK_FRAME_COUNT);
+
+    /* The band-limited versions should have at least 10dB less aliasing than the naive versions. */
+    for (iOscillator = 0; iOscillator < 6; iOscillator += 2) {
+        double naive       = test_oscillator_bank__measure_aliasing(pOutputs[iOscillator + 0], TEST_OSCILLATOR_BANK_FRAME_COUNT, frequency);
+        double bandLimited = test_oscillator_bank__measure_aliasing(pOutputs[iOscillator + 1], TEST_OSCILLATOR_BANK_FRAME_COUNT, frequency);
+
+        printf("      Type %d: %f -> %f\n", (int)types[iOscillator], naive, bandLimited);
+
+        if (bandLimited * 3.16 > naive) {
+            printf("      Band-limited waveform does not reduce aliasing enough.\n");
+            result = MA_ERROR;
+        }
+    }
+
+    ma_free(pBuffer, NULL);
+    ma_oscillator_bank_uninit(&bank, NULL);
+
+    return result;
+}
+
+int test_entry__oscillator_bank(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+
+    (void)argc;
+    (void)argv;
+
+    result = test_oscillator_bank__accuracy();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_oscillator_bank__aliasing();
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
@@ -85,6 +85,22 @@ ma_result test_waveform__f32()
         hasError = MA_TRUE;
     }
 
+    /* Band-limited */
+    result = test_waveform__by_format_and_type(ma_format_f32, ma_waveform_type_square_bandlimited, +amplitude, TEST_OUTPUT_DIR"/waveform_f32_square_bandlimited.wav");
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_waveform__by_format_and_type(ma_format_f32, ma_waveform_type_triangle_bandlimited, +amplitude, TEST_OUTPUT_DIR"/waveform_f32_triangle_bandlimited.wav");
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_waveform__by_format_and_type(ma_format_f32, ma_waveform_type_sawtooth_bandlimited, +amplitude, TEST_OUTPUT_DIR"/waveform_f32_sawtooth_bandlimited.wav");
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
 
     if (hasError) {
         return MA_ERROR;
@@ -0,0 +1,22 @@
+#define MA_NO_DEVICE_IO
+#define MA_DEBUG_AUDIO_THREAD_ALLOCATIONS
+#define MA_ENABLE_NODE_PROFILING
+#include "../common/common.c"
+#include "../../extras/nodes/ma_convolution_node/ma_convolution_node.c"
+#include "../../extras/nodes/ma_ambisonic_node/ma_ambisonic_node.c"
+
+#include "nodes_allocations.c"
+#include "nodes_convolution.c"
+#include "nodes_spectrum_analyzer.c"
+#include "nodes_profiling.c"
+
+int main(int argc, char** argv)
+{
+    ma_register_test("Audio Thread Allocations", test_entry__audio_thread_allocations);
+    ma_register_test("Binaural",                 test_entry__binaural);
+    ma_register_test("Convolution",              test_entry__convolution);
+    ma_register_test("Spectrum Analyzer",        test_entry__spectrum_analyzer);
+    ma_register_test("Profiling",                test_entry__profiling);
+
+    return ma_run_tests(argc, argv);
+}
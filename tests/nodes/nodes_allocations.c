@@ -0,0 +1,158 @@
+/* A source node that allocates and frees a block of memory each time it's processed. */
+typedef struct
+{
+    ma_node_base base;
+    int allocationLine;     /* The line of the ma_malloc() call, for checking the callsite that gets reported. */
+} test_allocating_node;
+
+static void test_allocating_node_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    test_allocating_node* pAllocatingNode = (test_allocating_node*)pNode;
+    void* p;
+
+    (void)ppFramesIn;
+    (void)pFrameCountIn;
+
+    pAllocatingNode->allocationLine = __LINE__ + 1;
+    p = ma_malloc(64, NULL);
+    ma_free(p, NULL);
+
+    ma_silence_pcm_frames(ppFramesOut[0], *pFrameCountOut, ma_format_f32, ma_node_get_output_channels(pNode, 0));
+}
+
+static ma_node_vtable g_test_allocating_node_vtable =
+{
+    test_allocating_node_process,
+    NULL,
+    0,  /* 0 input buses. */
+    1,  /* 1 output bus. */
+    0
+};
+
+typedef struct
+{
+    ma_uint32 warningCount;
+    char message[256];      /* The first warning that was posted. */
+} test_allocation_log;
+
+static void test_allocation_log_callback(void* pUserData, ma_uint32 level, const char* pMessage)
+{
+    test_allocation_log* pCapture = (test_allocation_log*)pUserData;
+
+    if (level != MA_LOG_LEVEL_WARNING) {
+        return;
+    }
+
+    if (pCapture->warningCount == 0) {
+        ma_strncpy_s(pCapture->message, sizeof(pCapture->message), pMessage, (size_t)-1);
+    }
+
+    pCapture->warningCount += 1;
+}
+
+/*
+Allocations made by a node while the engine is reading should be counted and posted to the engine's log with the file and line of the call.
+Allocations made outside of a read must not be counted.
+*/
+int test_entry__audio_thread_allocations(int argc, char** argv)
+{
+    ma_result result;
+    ma_log log;
+    test_allocation_log capture;
+    ma_engine_config engineConfig;
+    ma_engine engine;
+    ma_node_config nodeConfig;
+    test_allocating_node node;
+    ma_uint32 channels = 2;
+    float frames[256 * 2];
+    ma_uint64 countBefore;
+    ma_uint64 countAfter;
+    char expectedCallsite[64];
+    void* p;
+    int exitCode = 0;
+
+    (void)argc;
+    (void)argv;
+
+    MA_ZERO_OBJECT(&capture);
+
+    result = ma_log_init(NULL, &log);
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    ma_log_register_callback(&log, ma_log_callback_init(test_allocation_log_callback, &capture));
+
+    engineConfig = ma_engine_config_init();
+    engineConfig.noDevice   = MA_TRUE;
+    engineConfig.channels   = channels;
+    engineConfig.sampleRate = 48000;
+    engineConfig.pLog       = &log;
+
+    result = ma_engine_init(&engineConfig, &engine);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize engine. %s\n", ma_result_description(result));
+        ma_log_uninit(&log);
+        return -1;
+    }
+
+    nodeConfig = ma_node_config_init();
+    nodeConfig.vtable          = &g_test_allocating_node_vtable;
+    nodeConfig.pOutputChannels = &channels;
+
+    result = ma_node_init(ma_engine_get_node_graph(&engine), &nodeConfig, NULL, &node);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize node. %s\n", ma_result_description(result));
+        ma_engine_uninit(&engine);
+        ma_log_uninit(&log);
+        return -1;
+    }
+
+    ma_node_attach_output_bus(&node, 0, ma_engine_get_endpoint(&engine), 0);
+
+    /* Nothing is on the audio thread here. */
+    countBefore = ma_get_audio_thread_allocation_count();
+    p = ma_malloc(64, NULL);
+    ma_free(p, NULL);
+
+    if (ma_get_audio_thread_allocation_count() != countBefore || capture.warningCount != 0) {
+        printf("  An allocation outside of the audio thread was reported.\n");
+        exitCode = -1;
+        goto done;
+    }
+
+    /* The node is only processed once for a read that fits within the engine's period. */
+    result = ma_engine_read_pcm_frames(&engine, frames, 256, NULL);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to read from the engine. %s\n", ma_result_description(result));
+        exitCode = -1;
+        goto done;
+    }
+
+    countAfter = ma_get_audio_thread_allocation_count();
+    if (countAfter - countBefore != 2) {
+        printf("  Expecting 2 allocations to be counted, one for ma_malloc() and one for ma_free(). Got %u.\n", (unsigned int)(countAfter - countBefore));
+        exitCode = -1;
+        goto done;
+    }
+
+    if (capture.warningCount != 2) {
+        printf("  Expecting 2 warnings to be posted. Got %u.\n", (unsigned int)capture.warningCount);
+        exitCode = -1;
+        goto done;
+    }
+
+    sprintf(expectedCallsite, "nodes_allocations.c:%d.", node.allocationLine);
+    if (strstr(capture.message, "ma_malloc(64 bytes)") == NULL || strstr(capture.message, expectedCallsite) == NULL) {
+        printf("  Unexpected warning \"%s\". Expecting the ma_malloc() call at %s\n", capture.message, expectedCallsite);
+        exitCode = -1;
+        goto done;
+    }
+
+done:
+    ma_node_uninit(&node, NULL);
+    ma_engine_uninit(&engine);
+    ma_log_uninit(&log);
+
+    return exitCode;
+}
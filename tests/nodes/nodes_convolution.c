@@ -0,0 +1,379 @@
+#define CONVOLUTION_TEST_FRAME_COUNT    4096
+
+/* A source node that outputs an interleaved buffer and then silence. */
+typedef struct
+{
+    ma_node_base base;
+    const float* pFrames;
+    ma_uint32 channels;
+    ma_uint32 frameCount;
+    ma_uint32 cursor;
+} test_buffer_node;
+
+static void test_buffer_node_process(ma_node* pNode, const float** ppFramesIn, ma_uint32* pFrameCountIn, float** ppFramesOut, ma_uint32* pFrameCountOut)
+{
+    test_buffer_node* pBufferNode = (test_buffer_node*)pNode;
+    ma_uint32 frameCount = *pFrameCountOut;
+    ma_uint32 framesToCopy;
+
+    (void)ppFramesIn;
+    (void)pFrameCountIn;
+
+    framesToCopy = pBufferNode->frameCount - pBufferNode->cursor;
+    if (framesToCopy > frameCount) {
+        framesToCopy = frameCount;
+    }
+
+    MA_COPY_MEMORY(ppFramesOut[0], pBufferNode->pFrames + pBufferNode->cursor*pBufferNode->channels, framesToCopy * pBufferNode->channels * sizeof(float));
+    ma_silence_pcm_frames(ppFramesOut[0] + framesToCopy*pBufferNode->channels, frameCount - framesToCopy, ma_format_f32, pBufferNode->channels);
+
+    pBufferNode->cursor += framesToCopy;
+}
+
+static ma_node_vtable g_test_buffer_node_vtable =
+{
+    test_buffer_node_process,
+    NULL,
+    0,  /* 0 input buses. */
+    1,  /* 1 output bus. */
+    0
+};
+
+static ma_result test_buffer_node_init(ma_node_graph* pNodeGraph, const float* pFrames, ma_uint32 channels, ma_uint32 frameCount, test_buffer_node* pBufferNode)
+{
+    ma_node_config nodeConfig;
+
+    MA_ZERO_OBJECT(pBufferNode);
+    pBufferNode->pFrames    = pFrames;
+    pBufferNode->channels   = channels;
+    pBufferNode->frameCount = frameCount;
+
+    nodeConfig = ma_node_config_init();
+    nodeConfig.vtable          = &g_test_buffer_node_vtable;
+    nodeConfig.pOutputChannels = &channels;
+
+    return ma_node_init(pNodeGraph, &nodeConfig, NULL, pBufferNode);
+}
+
+static void test_convolution__fill_noise(ma_lcg* pLCG, float* pSamples, ma_uint32 sampleCount, float amplitude)
+{
+    ma_uint32 iSample;
+
+    for (iSample = 0; iSample < sampleCount; iSample += 1) {
+        pSamples[iSample] = ma_lcg_rand_range_f32(pLCG, -amplitude, amplitude);
+    }
+}
+
+/*
+Reads frameCount frames from the node graph in irregularly sized chunks so that the reads don't line up with the partitions of the
+convolution node.
+*/
+static ma_result test_convolution__read(ma_node_graph* pNodeGraph, float* pFrames, ma_uint32 channels, ma_uint32 frameCount)
+{
+    static const ma_uint32 chunkSizes[] = { 1, 37, 256, 500, 13, 128 };
+    ma_uint32 iChunk = 0;
+    ma_uint32 totalFramesRead = 0;
+
+    while (totalFramesRead < frameCount) {
+        ma_result result;
+        ma_uint64 framesRead;
+        ma_uint32 framesToRead = chunkSizes[iChunk % ma_countof(chunkSizes)];
+
+        if (framesToRead > frameCount - totalFramesRead) {
+            framesToRead = frameCount - totalFramesRead;
+        }
+
+        result = ma_node_graph_read_pcm_frames(pNodeGraph, pFrames + totalFramesRead*channels, framesToRead, &framesRead);
+        if (result != MA_SUCCESS || framesRead != framesToRead) {
+            printf("  Failed to read from the node graph. %s\n", ma_result_description(result));
+            return MA_ERROR;
+        }
+
+        totalFramesRead += framesToRead;
+        iChunk += 1;
+    }
+
+    return MA_SUCCESS;
+}
+
+/* Compares against the reference and prints the worst frame. */
+static ma_result test_convolution__compare(const float* pActual, const float* pExpected, ma_uint32 channels, ma_uint32 frameCount, float tolerance)
+{
+    ma_uint32 iSample;
+    ma_uint32 worstSample = 0;
+    float worstError = 0;
+
+    for (iSample = 0; iSample < frameCount*channels; iSample += 1) {
+        float error = (float)fabs(pActual[iSample] - pExpected[iSample]);
+        if (error > worstError) {
+            worstError  = error;
+            worstSample = iSample;
+        }
+    }
+
+    if (worstError > tolerance) {
+        printf("  Channel %u of frame %u is %f. Expecting %f.\n", worstSample % channels, worstSample / channels, pActual[worstSample], pExpected[worstSample]);
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+/*
+The binaural node should match every ambisonic channel convolved directly with its pair of impulse responses and summed per ear. The
+impulse responses are several partitions long so that the FFT stages are used as well as the time domain head.
+*/
+int test_entry__binaural(int argc, char** argv)
+{
+    ma_result result;
+    ma_uint32 order = 1;
+    ma_uint32 channels = ma_ambisonic_get_channel_count(order);
+    ma_uint32 length = 700;
+    ma_lcg lcg;
+    float* pInput = NULL;
+    float* pImpulseResponses = NULL;
+    float* pExpected = NULL;
+    float* pOutput = NULL;
+    ma_node_graph_config nodeGraphConfig;
+    ma_node_graph nodeGraph;
+    test_buffer_node source;
+    ma_ambisonic_binaural_node_config binauralConfig;
+    ma_ambisonic_binaural_node binaural;
+    ma_uint32 iFrame;
+    ma_uint32 iChannel;
+    ma_uint32 iEar;
+    ma_uint32 iTap;
+    int exitCode = -1;
+
+    (void)argc;
+    (void)argv;
+
+    ma_lcg_seed(&lcg, 4321);
+
+    pInput            = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * channels * sizeof(float), NULL);
+    pImpulseResponses = (float*)ma_malloc(channels * 2 * length * sizeof(float), NULL);
+    pExpected         = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * 2 * sizeof(float), NULL);
+    pOutput           = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * 2 * sizeof(float), NULL);
+    if (pInput == NULL || pImpulseResponses == NULL || pExpected == NULL || pOutput == NULL) {
+        goto done_alloc;
+    }
+
+    test_convolution__fill_noise(&lcg, pInput, CONVOLUTION_TEST_FRAME_COUNT * channels, 0.5f);
+    test_convolution__fill_noise(&lcg, pImpulseResponses, channels * 2 * length, 0.05f);
+
+    for (iFrame = 0; iFrame < CONVOLUTION_TEST_FRAME_COUNT; iFrame += 1) {
+        for (iEar = 0; iEar < 2; iEar += 1) {
+            double sum = 0;
+
+            for (iChannel = 0; iChannel < channels; iChannel += 1) {
+                const float* pResponse = pImpulseResponses + (iChannel*2 + iEar)*length;
+
+                for (iTap = 0; iTap < length && iTap <= iFrame; iTap += 1) {
+                    sum += pResponse[iTap] * pInput[(iFrame - iTap)*channels + iChannel];
+                }
+            }
+
+            pExpected[iFrame*2 + iEar] = (float)sum;
+        }
+    }
+
+    nodeGraphConfig = ma_node_graph_config_init(2);
+    result = ma_node_graph_init(&nodeGraphConfig, NULL, &nodeGraph);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize node graph. %s\n", ma_result_description(result));
+        goto done_alloc;
+    }
+
+    result = test_buffer_node_init(&nodeGraph, pInput, channels, CONVOLUTION_TEST_FRAME_COUNT, &source);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize source node. %s\n", ma_result_description(result));
+        goto done_graph;
+    }
+
+    binauralConfig = ma_ambisonic_binaural_node_config_init(order, pImpulseResponses, length);
+    binauralConfig.partitionSizeInFrames = 64;
+
+    result = ma_ambisonic_binaural_node_init(&nodeGraph, &binauralConfig, NULL, &binaural);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize binaural node. %s\n", ma_result_description(result));
+        goto done_source;
+    }
+
+    ma_node_attach_output_bus(&source, 0, &binaural, 0);
+    ma_node_attach_output_bus(&binaural, 0, ma_node_graph_get_endpoint(&nodeGraph), 0);
+
+    result = test_convolution__read(&nodeGraph, pOutput, 2, CONVOLUTION_TEST_FRAME_COUNT);
+    if (result == MA_SUCCESS) {
+        result = test_convolution__compare(pOutput, pExpected, 2, CONVOLUTION_TEST_FRAME_COUNT, 1e-4f);
+    }
+
+    if (result == MA_SUCCESS) {
+        exitCode = 0;
+    }
+
+    ma_ambisonic_binaural_node_uninit(&binaural, NULL);
+done_source:
+    ma_node_uninit(&source, NULL);
+done_graph:
+    ma_node_graph_uninit(&nodeGraph, NULL);
+done_alloc:
+    ma_free(pInput, NULL);
+    ma_free(pImpulseResponses, NULL);
+    ma_free(pExpected, NULL);
+    ma_free(pOutput, NULL);
+
+    return exitCode;
+}
+
+/*
+Direct convolution following the channel rules in ma_convolution_node.h. The impulse response is interleaved and is a matrix when it
+has channelsIn*channelsOut channels with more than one input.
+*/
+static void test_convolution__reference(const float* pInput, ma_uint32 channelsIn, ma_uint32 frameCount, const float* pImpulseResponse, ma_uint32 impulseResponseChannels, ma_uint32 length, ma_uint32 channelsOut, float* pOutput)
+{
+    ma_bool32 isMatrix = channelsIn > 1 && impulseResponseChannels == channelsIn*channelsOut;
+    ma_uint32 iFrame;
+    ma_uint32 iChannelOut;
+    ma_uint32 iChannelIn;
+    ma_uint32 iTap;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        for (iChannelOut = 0; iChannelOut < channelsOut; iChannelOut += 1) {
+            double sum = 0;
+
+            for (iChannelIn = 0; iChannelIn < channelsIn; iChannelIn += 1) {
+                ma_uint32 iChannelIR;
+
+                if (isMatrix) {
+                    iChannelIR = iChannelIn*channelsOut + iChannelOut;
+                } else {
+                    if (channelsIn > 1 && iChannelIn != iChannelOut) {
+                        continue;
+                    }
+
+                    iChannelIR = (impulseResponseChannels == 1) ? 0 : iChannelOut;
+                }
+
+                for (iTap = 0; iTap < length && iTap <= iFrame; iTap += 1) {
+                    sum += pImpulseResponse[iTap*impulseResponseChannels + iChannelIR] * pInput[(iFrame - iTap)*channelsIn + iChannelIn];
+                }
+            }
+
+            pOutput[iFrame*channelsOut + iChannelOut] = (float)sum;
+        }
+    }
+}
+
+typedef struct
+{
+    ma_uint32 channelsIn;
+    ma_uint32 channelsOut;
+    ma_uint32 impulseResponseChannels;
+    ma_bool32 uniformPartitions;
+} test_convolution_case;
+
+static ma_result test_convolution__run_case(const test_convolution_case* pCase, ma_lcg* pLCG)
+{
+    ma_result result;
+    ma_uint32 length = 3000;    /* With 16 frame partitions this is long enough for every stage to be used. */
+    float* pInput;
+    float* pImpulseResponse;
+    float* pExpected;
+    float* pOutput;
+    ma_node_graph_config nodeGraphConfig;
+    ma_node_graph nodeGraph;
+    test_buffer_node source;
+    ma_convolution_node_config convolutionConfig;
+    ma_convolution_node convolution;
+
+    pInput           = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * pCase->channelsIn * sizeof(float), NULL);
+    pImpulseResponse = (float*)ma_malloc(length * pCase->impulseResponseChannels * sizeof(float), NULL);
+    pExpected        = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * pCase->channelsOut * sizeof(float), NULL);
+    pOutput          = (float*)ma_malloc(CONVOLUTION_TEST_FRAME_COUNT * pCase->channelsOut * sizeof(float), NULL);
+    if (pInput == NULL || pImpulseResponse == NULL || pExpected == NULL || pOutput == NULL) {
+        result = MA_OUT_OF_MEMORY;
+        goto done_alloc;
+    }
+
+    test_convolution__fill_noise(pLCG, pInput, CONVOLUTION_TEST_FRAME_COUNT * pCase->channelsIn, 0.5f);
+    test_convolution__fill_noise(pLCG, pImpulseResponse, length * pCase->impulseResponseChannels, 0.02f);
+    test_convolution__reference(pInput, pCase->channelsIn, CONVOLUTION_TEST_FRAME_COUNT, pImpulseResponse, pCase->impulseResponseChannels, length, pCase->channelsOut, pExpected);
+
+    nodeGraphConfig = ma_node_graph_config_init(pCase->channelsOut);
+    result = ma_node_graph_init(&nodeGraphConfig, NULL, &nodeGraph);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize node graph. %s\n", ma_result_description(result));
+        goto done_alloc;
+    }
+
+    result = test_buffer_node_init(&nodeGraph, pInput, pCase->channelsIn, CONVOLUTION_TEST_FRAME_COUNT, &source);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize source node. %s\n", ma_result_description(result));
+        goto done_graph;
+    }
+
+    convolutionConfig = ma_convolution_node_config_init(pCase->channelsIn, pCase->channelsOut, pImpulseResponse, pCase->impulseResponseChannels, length);
+    convolutionConfig.partitionSizeInFrames = 16;
+    convolutionConfig.uniformPartitions     = pCase->uniformPartitions;
+
+    result = ma_convolution_node_init(&nodeGraph, &convolutionConfig, NULL, &convolution);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize convolution node. %s\n", ma_result_description(result));
+        goto done_source;
+    }
+
+    ma_node_attach_output_bus(&source, 0, &convolution, 0);
+    ma_node_attach_output_bus(&convolution, 0, ma_node_graph_get_endpoint(&nodeGraph), 0);
+
+    result = test_convolution__read(&nodeGraph, pOutput, pCase->channelsOut, CONVOLUTION_TEST_FRAME_COUNT);
+    if (result == MA_SUCCESS) {
+        result = test_convolution__compare(pOutput, pExpected, pCase->channelsOut, CONVOLUTION_TEST_FRAME_COUNT, 1e-4f);
+    }
+
+    ma_convolution_node_uninit(&convolution, NULL);
+done_source:
+    ma_node_uninit(&source, NULL);
+done_graph:
+    ma_node_graph_uninit(&nodeGraph, NULL);
+done_alloc:
+    ma_free(pInput, NULL);
+    ma_free(pImpulseResponse, NULL);
+    ma_free(pExpected, NULL);
+    ma_free(pOutput, NULL);
+
+    return result;
+}
+
+/* Partitioned FFT convolution should match direct convolution for every channel layout, with growing and uniform partitions. */
+int test_entry__convolution(int argc, char** argv)
+{
+    static const test_convolution_case cases[] =
+    {
+        /* in  out  ir  uniform */
+        {  1,  1,   1,  MA_FALSE },
+        {  1,  2,   2,  MA_FALSE },
+        {  2,  2,   1,  MA_FALSE },
+        {  2,  2,   2,  MA_TRUE  },
+        {  2,  3,   6,  MA_FALSE }
+    };
+    ma_lcg lcg;
+    ma_uint32 iCase;
+    int exitCode = 0;
+
+    (void)argc;
+    (void)argv;
+
+    ma_lcg_seed(&lcg, 1234);
+
+    for (iCase = 0; iCase < ma_countof(cases); iCase += 1) {
+        const test_convolution_case* pCase = &cases[iCase];
+
+        printf("  %u in, %u out, %u impulse response channels%s\n", pCase->channelsIn, pCase->channelsOut, pCase->impulseResponseChannels, pCase->uniformPartitions ? ", uniform partitions" : "");
+
+        if (test_convolution__run_case(pCase, &lcg) != MA_SUCCESS) {
+            exitCode = -1;
+        }
+    }
+
+    return exitCode;
+}
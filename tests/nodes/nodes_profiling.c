@@ -0,0 +1,171 @@
+#define PROFILING_TEST_FRAME_COUNT  4800
+#define PROFILING_TEST_READ_SIZE    480
+
+typedef struct
+{
+    ma_uint32 lineCount;
+    ma_bool32 hasGraphLine;
+    ma_bool32 hasSourceLine;
+    ma_bool32 hasListedAboveLine;
+} test_profiling_log;
+
+static void test_profiling_log_callback(void* pUserData, ma_uint32 level, const char* pMessage)
+{
+    test_profiling_log* pCapture = (test_profiling_log*)pUserData;
+
+    if (level != MA_LOG_LEVEL_INFO) {
+        return;
+    }
+
+    pCapture->lineCount += 1;
+
+    if (strstr(pMessage, "Node graph:") != NULL) {
+        pCapture->hasGraphLine = MA_TRUE;
+    }
+    if (strstr(pMessage, "test source") != NULL) {
+        pCapture->hasSourceLine = MA_TRUE;
+    }
+    if (strstr(pMessage, "(listed above)") != NULL) {
+        pCapture->hasListedAboveLine = MA_TRUE;
+    }
+}
+
+static ma_bool32 test_profiling__is_zero(const ma_node_profile* pProfile)
+{
+    return
+        pProfile->processCallCount            == 0 &&
+        pProfile->processTimeInNanoseconds    == 0 &&
+        pProfile->maxProcessTimeInNanoseconds == 0 &&
+        pProfile->framesProcessedIn           == 0 &&
+        pProfile->framesProcessedOut          == 0 &&
+        pProfile->cacheHitCount               == 0 &&
+        pProfile->cacheMissCount              == 0;
+}
+
+/*
+A source feeds a splitter whose two outputs are both attached to the endpoint. The splitter is processed once per read and the second
+output is served from its cache, so it should record one miss and one hit per read. The dump should list the splitter's subtree in full
+the first time and refer back to it the second time. Uses test_buffer_node from nodes_convolution.c as the source.
+*/
+int test_entry__profiling(int argc, char** argv)
+{
+    ma_result result;
+    ma_log log;
+    test_profiling_log capture;
+    float* pInput = NULL;
+    float frames[PROFILING_TEST_READ_SIZE * 2];
+    ma_node_graph_config nodeGraphConfig;
+    ma_node_graph nodeGraph;
+    test_buffer_node source;
+    ma_splitter_node_config splitterConfig;
+    ma_splitter_node splitter;
+    ma_node_profile graphProfile;
+    ma_node_profile sourceProfile;
+    ma_node_profile splitterProfile;
+    ma_uint32 readCount = PROFILING_TEST_FRAME_COUNT / PROFILING_TEST_READ_SIZE;
+    ma_uint32 iRead;
+    int exitCode = -1;
+
+    (void)argc;
+    (void)argv;
+
+    MA_ZERO_OBJECT(&capture);
+
+    pInput = (float*)ma_calloc(PROFILING_TEST_FRAME_COUNT * 2 * sizeof(float), NULL);
+    if (pInput == NULL) {
+        return -1;
+    }
+
+    result = ma_log_init(NULL, &log);
+    if (result != MA_SUCCESS) {
+        ma_free(pInput, NULL);
+        return -1;
+    }
+
+    ma_log_register_callback(&log, ma_log_callback_init(test_profiling_log_callback, &capture));
+
+    nodeGraphConfig = ma_node_graph_config_init(2);
+    result = ma_node_graph_init(&nodeGraphConfig, NULL, &nodeGraph);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize node graph. %s\n", ma_result_description(result));
+        goto done_log;
+    }
+
+    result = test_buffer_node_init(&nodeGraph, pInput, 2, PROFILING_TEST_FRAME_COUNT, &source);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize source node. %s\n", ma_result_description(result));
+        goto done_graph;
+    }
+
+    splitterConfig = ma_splitter_node_config_init(2);
+    result = ma_splitter_node_init(&nodeGraph, &splitterConfig, NULL, &splitter);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize splitter node. %s\n", ma_result_description(result));
+        goto done_source;
+    }
+
+    ma_node_set_profile_name(&source, "test source");
+
+    ma_node_attach_output_bus(&source,   0, &splitter, 0);
+    ma_node_attach_output_bus(&splitter, 0, ma_node_graph_get_endpoint(&nodeGraph), 0);
+    ma_node_attach_output_bus(&splitter, 1, ma_node_graph_get_endpoint(&nodeGraph), 0);
+
+    for (iRead = 0; iRead < readCount; iRead += 1) {
+        result = ma_node_graph_read_pcm_frames(&nodeGraph, frames, PROFILING_TEST_READ_SIZE, NULL);
+        if (result != MA_SUCCESS) {
+            printf("  Failed to read from the node graph. %s\n", ma_result_description(result));
+            goto done_splitter;
+        }
+    }
+
+    ma_node_graph_get_profile(&nodeGraph, &graphProfile);
+    ma_node_get_profile(&source, &sourceProfile);
+    ma_node_get_profile(&splitter, &splitterProfile);
+
+    if (graphProfile.processCallCount != readCount || graphProfile.framesProcessedOut != PROFILING_TEST_FRAME_COUNT || graphProfile.maxProcessTimeInNanoseconds > graphProfile.processTimeInNanoseconds) {
+        printf("  Unexpected graph profile. %u reads, %u frames, %u ns, max %u ns.\n", (unsigned int)graphProfile.processCallCount, (unsigned int)graphProfile.framesProcessedOut, (unsigned int)graphProfile.processTimeInNanoseconds, (unsigned int)graphProfile.maxProcessTimeInNanoseconds);
+        goto done_splitter;
+    }
+
+    if (sourceProfile.processCallCount == 0 || sourceProfile.framesProcessedOut != PROFILING_TEST_FRAME_COUNT || sourceProfile.framesProcessedIn != 0) {
+        printf("  Unexpected source profile. %u calls, %u frames in, %u frames out.\n", (unsigned int)sourceProfile.processCallCount, (unsigned int)sourceProfile.framesProcessedIn, (unsigned int)sourceProfile.framesProcessedOut);
+        goto done_splitter;
+    }
+
+    if (splitterProfile.framesProcessedIn != PROFILING_TEST_FRAME_COUNT || splitterProfile.framesProcessedOut != PROFILING_TEST_FRAME_COUNT || splitterProfile.cacheMissCount != readCount || splitterProfile.cacheHitCount != readCount) {
+        printf("  Unexpected splitter profile. %u frames in, %u frames out, %u cache misses, %u cache hits.\n", (unsigned int)splitterProfile.framesProcessedIn, (unsigned int)splitterProfile.framesProcessedOut, (unsigned int)splitterProfile.cacheMissCount, (unsigned int)splitterProfile.cacheHitCount);
+        goto done_splitter;
+    }
+
+    result = ma_node_graph_dump_profile(&nodeGraph, &log, 48000);
+    if (result != MA_SUCCESS || !capture.hasGraphLine || !capture.hasSourceLine || !capture.hasListedAboveLine) {
+        printf("  Unexpected profile dump. %u lines. %s\n", capture.lineCount, ma_result_description(result));
+        goto done_splitter;
+    }
+
+    /* Resetting the graph resets every node attached to it. */
+    ma_node_graph_reset_profile(&nodeGraph);
+
+    ma_node_graph_get_profile(&nodeGraph, &graphProfile);
+    ma_node_get_profile(&source, &sourceProfile);
+    ma_node_get_profile(&splitter, &splitterProfile);
+
+    if (!test_profiling__is_zero(&graphProfile) || !test_profiling__is_zero(&sourceProfile) || !test_profiling__is_zero(&splitterProfile)) {
+        printf("  The profiles were not reset.\n");
+        goto done_splitter;
+    }
+
+    exitCode = 0;
+
+done_splitter:
+    ma_splitter_node_uninit(&splitter, NULL);
+done_source:
+    ma_node_uninit(&source, NULL);
+done_graph:
+    ma_node_graph_uninit(&nodeGraph, NULL);
+done_log:
+    ma_log_uninit(&log);
+    ma_free(pInput, NULL);
+
+    return exitCode;
+}
@@ -0,0 +1,146 @@
+#define SPECTRUM_TEST_FFT_SIZE      1024
+#define SPECTRUM_TEST_FRAME_COUNT   4096
+#define SPECTRUM_TEST_CHANNELS      2
+
+/*
+Each channel is a sine wave at the centre of a bin so there's no scalloping loss and all of the energy is in that bin and its two
+neighbours, which get half each from the Hann window. The magnitudes are normalized so the peak should be the amplitude of the sine.
+Uses test_buffer_node from nodes_convolution.c as the source.
+*/
+int test_entry__spectrum_analyzer(int argc, char** argv)
+{
+    static const ma_uint32 bins[SPECTRUM_TEST_CHANNELS]       = { 64,   201   };
+    static const float     amplitudes[SPECTRUM_TEST_CHANNELS] = { 1.0f, 0.25f };
+    ma_result result;
+    float* pInput = NULL;
+    float* pOutput = NULL;
+    float* pMagnitudes = NULL;
+    ma_node_graph_config nodeGraphConfig;
+    ma_node_graph nodeGraph;
+    test_buffer_node source;
+    ma_spectrum_analyzer_node_config analyzerConfig;
+    ma_spectrum_analyzer_node analyzer;
+    ma_uint32 binCount = SPECTRUM_TEST_FFT_SIZE/2 + 1;
+    ma_uint64 sequence;
+    ma_uint32 iFrame;
+    ma_uint32 iChannel;
+    ma_uint32 iBin;
+    int exitCode = -1;
+
+    (void)argc;
+    (void)argv;
+
+    pInput      = (float*)ma_malloc(SPECTRUM_TEST_FRAME_COUNT * SPECTRUM_TEST_CHANNELS * sizeof(float), NULL);
+    pOutput     = (float*)ma_malloc(SPECTRUM_TEST_FRAME_COUNT * SPECTRUM_TEST_CHANNELS * sizeof(float), NULL);
+    pMagnitudes = (float*)ma_malloc(binCount * SPECTRUM_TEST_CHANNELS * sizeof(float), NULL);
+    if (pInput == NULL || pOutput == NULL || pMagnitudes == NULL) {
+        goto done_alloc;
+    }
+
+    for (iFrame = 0; iFrame < SPECTRUM_TEST_FRAME_COUNT; iFrame += 1) {
+        for (iChannel = 0; iChannel < SPECTRUM_TEST_CHANNELS; iChannel += 1) {
+            pInput[iFrame*SPECTRUM_TEST_CHANNELS + iChannel] = amplitudes[iChannel] * (float)ma_sind(2 * MA_PI_D * bins[iChannel] * iFrame / SPECTRUM_TEST_FFT_SIZE);
+        }
+    }
+
+    nodeGraphConfig = ma_node_graph_config_init(SPECTRUM_TEST_CHANNELS);
+    result = ma_node_graph_init(&nodeGraphConfig, NULL, &nodeGraph);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize node graph. %s\n", ma_result_description(result));
+        goto done_alloc;
+    }
+
+    result = test_buffer_node_init(&nodeGraph, pInput, SPECTRUM_TEST_CHANNELS, SPECTRUM_TEST_FRAME_COUNT, &source);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize source node. %s\n", ma_result_description(result));
+        goto done_graph;
+    }
+
+    analyzerConfig = ma_spectrum_analyzer_node_config_init(SPECTRUM_TEST_CHANNELS, SPECTRUM_TEST_FFT_SIZE);
+
+    result = ma_spectrum_analyzer_node_init(&nodeGraph, &analyzerConfig, NULL, &analyzer);
+    if (result != MA_SUCCESS) {
+        printf("  Failed to initialize spectrum analyzer node. %s\n", ma_result_description(result));
+        goto done_source;
+    }
+
+    ma_node_attach_output_bus(&source, 0, &analyzer, 0);
+    ma_node_attach_output_bus(&analyzer, 0, ma_node_graph_get_endpoint(&nodeGraph), 0);
+
+    if (ma_spectrum_analyzer_node_get_bin_count(&analyzer) != binCount) {
+        printf("  Expecting %u bins. Got %u.\n", binCount, ma_spectrum_analyzer_node_get_bin_count(&analyzer));
+        goto done_analyzer;
+    }
+
+    result = ma_spectrum_analyzer_node_get_magnitudes(&analyzer, pMagnitudes, &sequence);
+    if (result != MA_NO_DATA_AVAILABLE || sequence != 0) {
+        printf("  Magnitudes were returned before anything was analyzed.\n");
+        goto done_analyzer;
+    }
+
+    result = test_convolution__read(&nodeGraph, pOutput, SPECTRUM_TEST_CHANNELS, SPECTRUM_TEST_FRAME_COUNT);
+    if (result != MA_SUCCESS) {
+        goto done_analyzer;
+    }
+
+    /* The analyzer is a passthrough so the output should be untouched. */
+    if (memcmp(pOutput, pInput, SPECTRUM_TEST_FRAME_COUNT * SPECTRUM_TEST_CHANNELS * sizeof(float)) != 0) {
+        printf("  The output is not the same as the input.\n");
+        goto done_analyzer;
+    }
+
+    /* The default hop size is half the FFT size. */
+    result = ma_spectrum_analyzer_node_get_magnitudes(&analyzer, pMagnitudes, &sequence);
+    if (result != MA_SUCCESS || sequence != SPECTRUM_TEST_FRAME_COUNT / (SPECTRUM_TEST_FFT_SIZE/2)) {
+        printf("  Expecting analysis %u. Got %u. %s\n", SPECTRUM_TEST_FRAME_COUNT / (SPECTRUM_TEST_FFT_SIZE/2), (unsigned int)sequence, ma_result_description(result));
+        goto done_analyzer;
+    }
+
+    for (iChannel = 0; iChannel < SPECTRUM_TEST_CHANNELS; iChannel += 1) {
+        const float* pChannelMagnitudes = pMagnitudes + iChannel*binCount;
+        ma_uint32 peakBin = 0;
+
+        for (iBin = 1; iBin < binCount; iBin += 1) {
+            if (pChannelMagnitudes[iBin] > pChannelMagnitudes[peakBin]) {
+                peakBin = iBin;
+            }
+        }
+
+        if (peakBin != bins[iChannel]) {
+            printf("  Expecting the peak of channel %u in bin %u. Got bin %u.\n", iChannel, bins[iChannel], peakBin);
+            goto done_analyzer;
+        }
+
+        for (iBin = 0; iBin < binCount; iBin += 1) {
+            float expected;
+
+            if (iBin == bins[iChannel]) {
+                expected = amplitudes[iChannel];
+            } else if (iBin + 1 == bins[iChannel] || iBin == bins[iChannel] + 1) {
+                expected = amplitudes[iChannel] * 0.5f;
+            } else {
+                expected = 0;
+            }
+
+            if (fabs(pChannelMagnitudes[iBin] - expected) > 1e-3) {
+                printf("  Bin %u of channel %u is %f. Expecting %f.\n", iBin, iChannel, pChannelMagnitudes[iBin], expected);
+                goto done_analyzer;
+            }
+        }
+    }
+
+    exitCode = 0;
+
+done_analyzer:
+    ma_spectrum_analyzer_node_uninit(&analyzer, NULL);
+done_source:
+    ma_node_uninit(&source, NULL);
+done_graph:
+    ma_node_graph_uninit(&nodeGraph, NULL);
+done_alloc:
+    ma_free(pInput, NULL);
+    ma_free(pOutput, NULL);
+    ma_free(pMagnitudes, NULL);
+
+    return exitCode;
+}
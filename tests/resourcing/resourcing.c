@@ -0,0 +1,149 @@
+#define MA_NO_DEVICE_IO
+#define MA_RESOURCE_MANAGER_READ_SLICE_SIZE_IN_BYTES    (64*1024)   /* Small enough for the test file to be read in several slices. */
+#include "../common/common.c"
+
+#define RESOURCE_MANAGER_TEST_FILE_PATH         TEST_OUTPUT_DIR"/resource_manager_ramp.wav"
+#define RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT  (48000*10)
+
+/*
+Generates a mono f32 file where the value of each sample is its frame index. This makes it easy to check that a read returned the correct data
+for the current cursor position. Integers up to 2^24 can be represented exactly as a float.
+*/
+ma_result resource_manager_generate_test_file(void)
+{
+    ma_result result;
+    ma_encoder_config encoderConfig;
+    ma_encoder encoder;
+    float samples[4096];
+    ma_uint64 iFrame;
+
+    encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 1, 48000);
+    result = ma_encoder_init_file(RESOURCE_MANAGER_TEST_FILE_PATH, &encoderConfig, &encoder);
+    if (result != MA_SUCCESS) {
+        printf("Failed to open \"%s\" for encoding. %s\n", RESOURCE_MANAGER_TEST_FILE_PATH, ma_result_description(result));
+        return result;
+    }
+
+    for (iFrame = 0; iFrame < RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT; iFrame += ma_countof(samples)) {
+        ma_uint64 framesToWrite = ma_min(ma_countof(samples), RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT - iFrame);
+        ma_uint64 iSample;
+
+        for (iSample = 0; iSample < framesToWrite; iSample += 1) {
+            samples[iSample] = (float)(iFrame + iSample);
+        }
+
+        result = ma_encoder_write_pcm_frames(&encoder, samples, framesToWrite, NULL);
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+
+    ma_encoder_uninit(&encoder);
+
+    return result;
+}
+
+/* With a job thread count of 0 the resource manager is non-blocking and jobs are run with resource_manager_process_jobs(). */
+ma_result resource_manager_init(ma_uint32 flags, ma_uint32 jobThreadCount, ma_resource_manager* pResourceManager)
+{
+    ma_resource_manager_config resourceManagerConfig;
+
+    resourceManagerConfig = ma_resource_manager_config_init();
+    resourceManagerConfig.decodedFormat  = ma_format_f32;
+    resourceManagerConfig.flags          = flags;
+    resourceManagerConfig.jobThreadCount = jobThreadCount;
+
+    if (jobThreadCount == 0) {
+        resourceManagerConfig.flags |= MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING;
+    }
+
+    return ma_resource_manager_init(&resourceManagerConfig, pResourceManager);
+}
+
+/* Runs jobs on the calling thread until the queue is empty. Jobs that post themselves again are run as well. */
+void resource_manager_process_jobs(ma_resource_manager* pResourceManager)
+{
+    while (ma_resource_manager_process_next_job(pResourceManager) != MA_NO_DATA_AVAILABLE) {
+    }
+}
+
+/* Checks that each sample is equal to the frame index it was read from. */
+ma_bool32 resource_manager_check_ramp(const float* pSamples, ma_uint64 frameCount, ma_uint64 firstFrameIndex)
+{
+    ma_uint64 iFrame;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        if (pSamples[iFrame] != (float)(firstFrameIndex + iFrame)) {
+            printf("      Frame %u has a value of %f. Expecting %u.\n", (unsigned int)(firstFrameIndex + iFrame), pSamples[iFrame], (unsigned int)(firstFrameIndex + iFrame));
+            return MA_FALSE;
+        }
+    }
+
+    return MA_TRUE;
+}
+
+/* Reads from a data source, retrying while it's busy. Only stops short of frameCount when the end is reached. */
+ma_result resource_manager_read_wait(ma_data_source* pDataSource, float* pSamples, ma_uint64 frameCount, ma_uint64* pFramesRead)
+{
+    ma_result result = MA_SUCCESS;
+    ma_uint64 totalFramesRead = 0;
+    ma_uint32 attempts = 0;
+
+    while (totalFramesRead < frameCount) {
+        ma_uint64 framesRead = 0;
+
+        result = ma_data_source_read_pcm_frames(pDataSource, pSamples + totalFramesRead, frameCount - totalFramesRead, &framesRead);
+        totalFramesRead += framesRead;
+
+        if (result == MA_BUSY) {
+            attempts += 1;
+            if (attempts == 5000) {
+                printf("      Timed out waiting for data.\n");
+                result = MA_TIMEOUT;
+                break;
+            }
+
+            ma_sleep(1);
+            continue;
+        }
+
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+
+    if (pFramesRead != NULL) {
+        *pFramesRead = totalFramesRead;
+    }
+
+    if (result == MA_AT_END && totalFramesRead > 0) {
+        result = MA_SUCCESS;
+    }
+
+    return result;
+}
+
+#include "resourcing_shared_stream.c"
+#include "resourcing_decode_on_demand.c"
+#include "resourcing_batch.c"
+#include "resourcing_cancel.c"
+#include "resourcing_offline.c"
+#include "resourcing_paged_audio_buffer.c"
+#include "resourcing_job_threads.c"
+
+int main(int argc, char** argv)
+{
+    if (resource_manager_generate_test_file() != MA_SUCCESS) {
+        return 1;
+    }
+
+    ma_register_test("Shared Streams",      test_entry__shared_stream);
+    ma_register_test("Decode on Demand",    test_entry__decode_on_demand);
+    ma_register_test("Batches",             test_entry__batch);
+    ma_register_test("Cancellation",        test_entry__cancel);
+    ma_register_test("Offline",             test_entry__offline);
+    ma_register_test("Paged Audio Buffers", test_entry__paged_audio_buffer);
+    ma_register_test("Job Threads",         test_entry__job_threads);
+
+    return ma_run_tests(argc, argv);
+}
@@ -0,0 +1,199 @@
+#define BATCH_TEST_MISSING_FILE_PATH    TEST_OUTPUT_DIR"/resource_manager_missing.wav"
+
+/*
+A file that's already being loaded asynchronously by somebody else must not be counted by the batch until that load has finished. The
+asynchronous load is started first so that its job is queued ahead of the batch, but because the batch's job is the one that acquires
+the node in the middle of that load, the batch must keep waiting on it instead of counting it with whatever size it has at the time.
+*/
+ma_result test_batch__shared_node(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_buffer dataBuffer;
+    ma_resource_manager_batch batch;
+    ma_resource_manager_batch_config batchConfig;
+    ma_resource_manager_batch_progress progress;
+    ma_resource_manager_batch_item items[2];
+    ma_uint64 expectedSizeInBytes = (ma_uint64)RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT * sizeof(float);
+
+    printf("    Item shared with an asynchronous load\n");
+
+    result = ma_resource_manager_data_buffer_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC, NULL, &dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize data buffer. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    /* Run the first job of the asynchronous load so the node exists but hasn't finished decoding. */
+    ma_resource_manager_process_next_job(pResourceManager);
+    if (ma_resource_manager_data_buffer_node_result(dataBuffer.pNode) != MA_BUSY) {
+        printf("      The data buffer finished loading before the batch was started.\n");
+        ma_resource_manager_data_buffer_uninit(&dataBuffer);
+        resource_manager_process_jobs(pResourceManager);
+        return MA_ERROR;
+    }
+
+    MA_ZERO_MEMORY(items, sizeof(items));
+    items[0].pFilePath = RESOURCE_MANAGER_TEST_FILE_PATH;
+    items[0].flags     = MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE;
+    items[1].pFilePath = BATCH_TEST_MISSING_FILE_PATH;
+    items[1].flags     = MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE;
+
+    batchConfig = ma_resource_manager_batch_config_init(items, ma_countof(items));
+
+    result = ma_resource_manager_batch_init(pResourceManager, &batchConfig, &batch);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize batch. %s\n", ma_result_description(result));
+        ma_resource_manager_data_buffer_uninit(&dataBuffer);
+        resource_manager_process_jobs(pResourceManager);
+        return result;
+    }
+
+    /* Run one job at a time so we can check that the shared item is never reported before its node has finished. */
+    for (;;) {
+        ma_result jobResult = ma_resource_manager_process_next_job(pResourceManager);
+
+        ma_resource_manager_batch_get_progress(&batch, &progress);
+        if (ma_resource_manager_batch_get_item_result(&batch, 0) == MA_SUCCESS && ma_resource_manager_data_buffer_node_result(dataBuffer.pNode) == MA_BUSY) {
+            printf("      The shared item was counted while its node was still loading.\n");
+            result = MA_ERROR;
+            goto done;
+        }
+
+        if (progress.loadedCount + progress.failedCount > 0 && ma_resource_manager_batch_get_item_result(&batch, 0) == MA_BUSY && ma_resource_manager_batch_get_item_result(&batch, 1) == MA_BUSY) {
+            printf("      An item was counted before its result was set.\n");
+            result = MA_ERROR;
+            goto done;
+        }
+
+        if (jobResult == MA_NO_DATA_AVAILABLE) {
+            break;
+        }
+    }
+
+    result = ma_resource_manager_batch_result(&batch);
+    if (result != MA_SUCCESS) {
+        printf("      The batch returned %s after every job was run.\n", ma_result_description(result));
+        result = MA_ERROR;
+        goto done;
+    }
+
+    ma_resource_manager_batch_get_progress(&batch, &progress);
+
+    if (ma_resource_manager_batch_get_item_result(&batch, 0) != MA_SUCCESS || ma_resource_manager_batch_get_item_result(&batch, 1) == MA_SUCCESS) {
+        printf("      Unexpected item results: %s, %s.\n", ma_result_description(ma_resource_manager_batch_get_item_result(&batch, 0)), ma_result_description(ma_resource_manager_batch_get_item_result(&batch, 1)));
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (progress.loadedCount != 1 || progress.failedCount != 1 || progress.skippedCount != 0) {
+        printf("      Expecting 1 loaded and 1 failed item. Got %u loaded, %u failed and %u skipped.\n", (unsigned int)progress.loadedCount, (unsigned int)progress.failedCount, (unsigned int)progress.skippedCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (progress.loadedBytes != expectedSizeInBytes) {
+        printf("      Expecting %u loaded bytes. Got %u.\n", (unsigned int)expectedSizeInBytes, (unsigned int)progress.loadedBytes);
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    ma_resource_manager_batch_uninit(&batch);
+    resource_manager_process_jobs(pResourceManager);
+    ma_resource_manager_data_buffer_uninit(&dataBuffer);
+    resource_manager_process_jobs(pResourceManager);
+
+    return result;
+}
+
+/* Waiting on a batch must also wait for items that are shared with another load, not just for the batch's own jobs. */
+ma_result test_batch__wait_for_shared_node(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_buffer dataBuffer;
+    ma_resource_manager_batch batch;
+    ma_resource_manager_batch_config batchConfig;
+    ma_resource_manager_batch_progress progress;
+    ma_resource_manager_batch_item item;
+
+    printf("    Wait for an item shared with an asynchronous load\n");
+
+    result = ma_resource_manager_data_buffer_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC, NULL, &dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize data buffer. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    ma_resource_manager_process_next_job(pResourceManager);
+
+    MA_ZERO_OBJECT(&item);
+    item.pFilePath = RESOURCE_MANAGER_TEST_FILE_PATH;
+    item.flags     = MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE;
+
+    batchConfig = ma_resource_manager_batch_config_init(&item, 1);
+
+    result = ma_resource_manager_batch_init(pResourceManager, &batchConfig, &batch);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize batch. %s\n", ma_result_description(result));
+        ma_resource_manager_data_buffer_uninit(&dataBuffer);
+        resource_manager_process_jobs(pResourceManager);
+        return result;
+    }
+
+    result = ma_resource_manager_batch_wait(&batch);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to wait for batch. %s\n", ma_result_description(result));
+        goto done;
+    }
+
+    ma_resource_manager_batch_get_progress(&batch, &progress);
+    if (ma_resource_manager_data_buffer_node_result(dataBuffer.pNode) != MA_SUCCESS || progress.loadedCount != 1 || progress.loadedBytes != (ma_uint64)RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT * sizeof(float)) {
+        printf("      The batch returned before the shared item had finished loading.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    ma_resource_manager_batch_uninit(&batch);
+
+    /* The wait only runs jobs until the batch is done. The data buffer's own jobs need to finish before it can be uninitialized. */
+    resource_manager_process_jobs(pResourceManager);
+    ma_resource_manager_data_buffer_uninit(&dataBuffer);
+    resource_manager_process_jobs(pResourceManager);
+
+    return result;
+}
+
+int test_entry__batch(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_resource_manager resourceManager;
+
+    (void)argc;
+    (void)argv;
+
+    result = resource_manager_init(0, 0, &resourceManager);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return -1;
+    }
+
+    result = test_batch__shared_node(&resourceManager);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_batch__wait_for_shared_node(&resourceManager);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
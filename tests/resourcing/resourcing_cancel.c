@@ -0,0 +1,332 @@
+/*
+Counts the bytes read through it so we can tell how much of a file was read, and whether any of it was read more than once. Everything
+else is passed straight through to the default VFS.
+*/
+typedef struct
+{
+    ma_vfs_callbacks cb;
+    ma_default_vfs defaultVFS;
+    ma_uint64 bytesRead;
+} cancel_test_vfs;
+
+static ma_result cancel_test_vfs__on_open(ma_vfs* pVFS, const char* pFilePath, ma_uint32 openMode, ma_vfs_file* pFile)
+{
+    return ma_vfs_open(&((cancel_test_vfs*)pVFS)->defaultVFS, pFilePath, openMode, pFile);
+}
+
+static ma_result cancel_test_vfs__on_open_w(ma_vfs* pVFS, const wchar_t* pFilePath, ma_uint32 openMode, ma_vfs_file* pFile)
+{
+    return ma_vfs_open_w(&((cancel_test_vfs*)pVFS)->defaultVFS, pFilePath, openMode, pFile);
+}
+
+static ma_result cancel_test_vfs__on_close(ma_vfs* pVFS, ma_vfs_file file)
+{
+    return ma_vfs_close(&((cancel_test_vfs*)pVFS)->defaultVFS, file);
+}
+
+static ma_result cancel_test_vfs__on_read(ma_vfs* pVFS, ma_vfs_file file, void* pDst, size_t sizeInBytes, size_t* pBytesRead)
+{
+    ma_result result;
+    size_t bytesRead = 0;
+
+    result = ma_vfs_read(&((cancel_test_vfs*)pVFS)->defaultVFS, file, pDst, sizeInBytes, &bytesRead);
+    ((cancel_test_vfs*)pVFS)->bytesRead += bytesRead;
+
+    if (pBytesRead != NULL) {
+        *pBytesRead = bytesRead;
+    }
+
+    return result;
+}
+
+static ma_result cancel_test_vfs__on_write(ma_vfs* pVFS, ma_vfs_file file, const void* pSrc, size_t sizeInBytes, size_t* pBytesWritten)
+{
+    return ma_vfs_write(&((cancel_test_vfs*)pVFS)->defaultVFS, file, pSrc, sizeInBytes, pBytesWritten);
+}
+
+static ma_result cancel_test_vfs__on_seek(ma_vfs* pVFS, ma_vfs_file file, ma_int64 offset, ma_seek_origin origin)
+{
+    return ma_vfs_seek(&((cancel_test_vfs*)pVFS)->defaultVFS, file, offset, origin);
+}
+
+static ma_result cancel_test_vfs__on_tell(ma_vfs* pVFS, ma_vfs_file file, ma_int64* pCursor)
+{
+    return ma_vfs_tell(&((cancel_test_vfs*)pVFS)->defaultVFS, file, pCursor);
+}
+
+static ma_result cancel_test_vfs__on_info(ma_vfs* pVFS, ma_vfs_file file, ma_file_info* pInfo)
+{
+    return ma_vfs_info(&((cancel_test_vfs*)pVFS)->defaultVFS, file, pInfo);
+}
+
+static void cancel_test_vfs_init(cancel_test_vfs* pVFS)
+{
+    MA_ZERO_OBJECT(pVFS);
+    pVFS->cb.onOpen  = cancel_test_vfs__on_open;
+    pVFS->cb.onOpenW = cancel_test_vfs__on_open_w;
+    pVFS->cb.onClose = cancel_test_vfs__on_close;
+    pVFS->cb.onRead  = cancel_test_vfs__on_read;
+    pVFS->cb.onWrite = cancel_test_vfs__on_write;
+    pVFS->cb.onSeek  = cancel_test_vfs__on_seek;
+    pVFS->cb.onTell  = cancel_test_vfs__on_tell;
+    pVFS->cb.onInfo  = cancel_test_vfs__on_info;
+
+    ma_default_vfs_init(&pVFS->defaultVFS, NULL);
+}
+
+
+/* Keeps track of the number of live allocations so we can check that a cancelled read doesn't leak its buffer. */
+static void* cancel_test__malloc(size_t sz, void* pUserData)
+{
+    void* p = malloc(sz);
+    if (p != NULL) {
+        ma_atomic_fetch_add_i32((ma_int32*)pUserData, 1);
+    }
+
+    return p;
+}
+
+static void* cancel_test__realloc(void* p, size_t sz, void* pUserData)
+{
+    void* pNew = realloc(p, sz);
+    if (p == NULL && pNew != NULL) {
+        ma_atomic_fetch_add_i32((ma_int32*)pUserData, 1);
+    }
+
+    return pNew;
+}
+
+static void cancel_test__free(void* p, void* pUserData)
+{
+    if (p != NULL) {
+        ma_atomic_fetch_sub_i32((ma_int32*)pUserData, 1);
+    }
+
+    free(p);
+}
+
+
+/*
+While every data buffer using a node is waiting to be freed, reading the file is paused and the job is posted again. Each run must still read
+a slice, or else the job would spin without doing anything, and when the node is picked up again the read must carry on from where it
+stopped rather than starting over. The pending release is set directly so the free job doesn't get a chance to run in between.
+*/
+ma_result test_cancel__paused_read_resumes(ma_resource_manager* pResourceManager, cancel_test_vfs* pVFS, ma_int32* pAllocationCount)
+{
+    ma_result result;
+    ma_resource_manager_data_buffer dataBuffer;
+    ma_resource_manager_data_buffer_node* pDataBufferNode;
+    ma_int32 allocationCount = ma_atomic_load_i32(pAllocationCount);
+    float samples[256];
+    ma_uint64 framesRead;
+    ma_uint32 iJob;
+    ma_bool32 isPaused;
+
+    printf("    Paused read resumes\n");
+
+    pVFS->bytesRead = 0;
+
+    result = ma_resource_manager_data_buffer_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC, NULL, &dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize data buffer. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    pDataBufferNode = dataBuffer.pNode;
+    ma_atomic_fetch_add_32(&pDataBufferNode->pendingReleaseCount, 1);
+    isPaused = MA_TRUE;
+
+    /* The queue has the node's load job and the data buffer's load job, which both post themselves again while the node is loading. */
+    for (iJob = 0; iJob < 4; iJob += 1) {
+        ma_resource_manager_process_next_job(pResourceManager);
+    }
+
+    if (ma_resource_manager_data_buffer_node_result(pDataBufferNode) != MA_BUSY) {
+        printf("      The node finished loading while it was paused. %s.\n", ma_result_description(ma_resource_manager_data_buffer_node_result(pDataBufferNode)));
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (pVFS->bytesRead != 2 * MA_RESOURCE_MANAGER_READ_SLICE_SIZE_IN_BYTES) {
+        printf("      Expecting each paused run to read one slice (%u bytes). Read %u bytes in two runs.\n", (unsigned int)MA_RESOURCE_MANAGER_READ_SLICE_SIZE_IN_BYTES, (unsigned int)pVFS->bytesRead);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* The data buffer is still wanted after all. */
+    ma_atomic_fetch_sub_32(&pDataBufferNode->pendingReleaseCount, 1);
+    isPaused = MA_FALSE;
+    resource_manager_process_jobs(pResourceManager);
+
+    result = ma_resource_manager_data_buffer_result(&dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to load data buffer. %s\n", ma_result_description(result));
+        goto done;
+    }
+
+    if (pVFS->bytesRead != pDataBufferNode->data.backend.encoded.sizeInBytes) {
+        printf("      Read %u bytes for a file of %u bytes.\n", (unsigned int)pVFS->bytesRead, (unsigned int)pDataBufferNode->data.backend.encoded.sizeInBytes);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* The data either side of where the read was paused must be intact. */
+    ma_resource_manager_data_buffer_seek_to_pcm_frame(&dataBuffer, 2 * MA_RESOURCE_MANAGER_READ_SLICE_SIZE_IN_BYTES / sizeof(float) - ma_countof(samples));
+
+    result = resource_manager_read_wait(&dataBuffer, samples, ma_countof(samples), &framesRead);
+    if (result != MA_SUCCESS || framesRead != ma_countof(samples)) {
+        printf("      Failed to read from data buffer. %s.\n", ma_result_description(result));
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (resource_manager_check_ramp(samples, framesRead, 2 * MA_RESOURCE_MANAGER_READ_SLICE_SIZE_IN_BYTES / sizeof(float) - ma_countof(samples)) == MA_FALSE) {
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    if (isPaused) {
+        ma_atomic_fetch_sub_32(&pDataBufferNode->pendingReleaseCount, 1);
+    }
+
+    /* Without job threads the uninit would wait forever on a data buffer that's still loading. */
+    resource_manager_process_jobs(pResourceManager);
+    ma_resource_manager_data_buffer_uninit(&dataBuffer);
+    resource_manager_process_jobs(pResourceManager);
+
+    if (result == MA_SUCCESS && ma_atomic_load_i32(pAllocationCount) != allocationCount) {
+        printf("      %d allocations were not freed.\n", (int)(ma_atomic_load_i32(pAllocationCount) - allocationCount));
+        result = MA_ERROR;
+    }
+
+    return result;
+}
+
+typedef struct
+{
+    ma_resource_manager_data_buffer* pDataBuffer;
+    MA_ATOMIC(4, ma_bool32) isDone;
+} cancel_test_uninit;
+
+static ma_thread_result MA_THREADCALL cancel_test__uninit_thread(void* pUserData)
+{
+    cancel_test_uninit* pUninit = (cancel_test_uninit*)pUserData;
+
+    ma_resource_manager_data_buffer_uninit(pUninit->pDataBuffer);
+    ma_atomic_exchange_32(&pUninit->isDone, MA_TRUE);
+
+    return (ma_thread_result)0;
+}
+
+/*
+Uninitializing the only data buffer using a node stops the read part way through, and what was read so far must be freed. The uninit waits for
+its free job so it's done on another thread while this one runs the jobs. The node's load job doesn't run until the uninit has started so the
+read is always stopped early.
+*/
+ma_result test_cancel__unloaded_while_reading(ma_resource_manager* pResourceManager, cancel_test_vfs* pVFS, ma_int32* pAllocationCount)
+{
+    ma_result result;
+    ma_resource_manager_data_buffer dataBuffer;
+    ma_resource_manager_data_buffer_node* pDataBufferNode;
+    cancel_test_uninit uninit;
+    ma_thread thread;
+    ma_int32 allocationCount = ma_atomic_load_i32(pAllocationCount);
+
+    printf("    Unloaded while reading\n");
+
+    pVFS->bytesRead = 0;
+
+    result = ma_resource_manager_data_buffer_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC, NULL, &dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize data buffer. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    pDataBufferNode = dataBuffer.pNode;
+
+    MA_ZERO_OBJECT(&uninit);
+    uninit.pDataBuffer = &dataBuffer;
+
+    result = ma_thread_create(&thread, ma_thread_priority_default, 0, cancel_test__uninit_thread, &uninit, NULL);
+    if (result != MA_SUCCESS) {
+        resource_manager_process_jobs(pResourceManager);
+        ma_resource_manager_data_buffer_uninit(&dataBuffer);
+        return result;
+    }
+
+    /* The node can't be freed until we run its jobs so it's safe to look at it here. */
+    while (ma_atomic_load_32(&pDataBufferNode->pendingReleaseCount) == 0) {
+        ma_yield();
+    }
+
+    while (ma_atomic_load_32(&uninit.isDone) == MA_FALSE) {
+        if (ma_resource_manager_process_next_job(pResourceManager) == MA_NO_DATA_AVAILABLE) {
+            ma_yield();
+        }
+    }
+
+    ma_thread_wait(&thread);
+    resource_manager_process_jobs(pResourceManager);
+
+    if (pVFS->bytesRead == 0 || pVFS->bytesRead >= RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT * sizeof(float)) {
+        printf("      Expecting the read to stop part way through the file. Read %u bytes.\n", (unsigned int)pVFS->bytesRead);
+        result = MA_ERROR;
+    }
+
+    if (ma_atomic_load_i32(pAllocationCount) != allocationCount) {
+        printf("      %d allocations were not freed.\n", (int)(ma_atomic_load_i32(pAllocationCount) - allocationCount));
+        result = MA_ERROR;
+    }
+
+    return result;
+}
+
+int test_entry__cancel(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_resource_manager_config resourceManagerConfig;
+    ma_resource_manager resourceManager;
+    cancel_test_vfs vfs;
+    ma_int32 allocationCount = 0;
+
+    (void)argc;
+    (void)argv;
+
+    cancel_test_vfs_init(&vfs);
+
+    resourceManagerConfig = ma_resource_manager_config_init();
+    resourceManagerConfig.decodedFormat                  = ma_format_f32;
+    resourceManagerConfig.jobThreadCount                 = 0;
+    resourceManagerConfig.flags                          = MA_RESOURCE_MANAGER_FLAG_NON_BLOCKING;
+    resourceManagerConfig.pVFS                           = &vfs;
+    resourceManagerConfig.allocationCallbacks.pUserData  = &allocationCount;
+    resourceManagerConfig.allocationCallbacks.onMalloc   = cancel_test__malloc;
+    resourceManagerConfig.allocationCallbacks.onRealloc  = cancel_test__realloc;
+    resourceManagerConfig.allocationCallbacks.onFree     = cancel_test__free;
+
+    result = ma_resource_manager_init(&resourceManagerConfig, &resourceManager);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return -1;
+    }
+
+    result = test_cancel__paused_read_resumes(&resourceManager, &vfs, &allocationCount);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_cancel__unloaded_while_reading(&resourceManager, &vfs, &allocationCount);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
@@ -0,0 +1,145 @@
+#define DECODE_ON_DEMAND_TEST_FLAGS (MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE_ON_DEMAND | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_NO_BACKGROUND_DECODE)
+
+static ma_uint32 test_decode_on_demand__get_page_state(ma_resource_manager_data_buffer* pDataBuffer, ma_uint32 iPage)
+{
+    return ma_atomic_load_32(&pDataBuffer->pNode->pPageStates[iPage]);
+}
+
+/*
+Jobs are only run when we ask for them so we know exactly which pages have been decoded. Seeking into a page that hasn't been decoded
+should make reads return MA_BUSY until the paging job has been run, after which the data must be correct. The page after it should
+have been decoded as well so that a read running off the end of the page doesn't stall.
+*/
+ma_result test_decode_on_demand__seek_into_undecoded_page(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_buffer dataBuffer;
+    float samples[256];
+    ma_uint64 framesRead;
+    ma_uint64 cursor;
+    ma_uint32 pageSizeInFrames;
+
+    printf("    Seek into an undecoded page\n");
+
+    result = ma_resource_manager_data_buffer_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, DECODE_ON_DEMAND_TEST_FLAGS, NULL, &dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize data buffer. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    resource_manager_process_jobs(pResourceManager);
+
+    result = ma_resource_manager_data_buffer_result(&dataBuffer);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to load data buffer. %s\n", ma_result_description(result));
+        goto done;
+    }
+
+    if (dataBuffer.pNode->pPageStates == NULL || dataBuffer.pNode->pageCount < 8) {
+        printf("      The data buffer is not being decoded on demand.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* Nothing should have been decoded yet. */
+    if (test_decode_on_demand__get_page_state(&dataBuffer, 0) != MA_RESOURCE_MANAGER_PAGE_STATE_EMPTY) {
+        printf("      Page 0 was decoded before it was needed.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    pageSizeInFrames = dataBuffer.pNode->pageSizeInFrames;
+    cursor = (ma_uint64)pageSizeInFrames * 5 + 1000;
+
+    result = ma_resource_manager_data_buffer_seek_to_pcm_frame(&dataBuffer, cursor);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to seek. %s\n", ma_result_description(result));
+        goto done;
+    }
+
+    framesRead = 0;
+    result = ma_resource_manager_data_buffer_read_pcm_frames(&dataBuffer, samples, ma_countof(samples), &framesRead);
+    if (result != MA_BUSY || framesRead != 0) {
+        printf("      Reading an undecoded page returned %s with %u frames. Expecting MA_BUSY with 0 frames.\n", ma_result_description(result), (unsigned int)framesRead);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    resource_manager_process_jobs(pResourceManager);
+
+    result = ma_resource_manager_data_buffer_read_pcm_frames(&dataBuffer, samples, ma_countof(samples), &framesRead);
+    if (result != MA_SUCCESS || framesRead != ma_countof(samples)) {
+        printf("      Reading a decoded page returned %s with %u frames.\n", ma_result_description(result), (unsigned int)framesRead);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (resource_manager_check_ramp(samples, framesRead, cursor) == MA_FALSE) {
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* The page after the one that was read should have been requested along with it. Nothing else should have been touched. */
+    if (test_decode_on_demand__get_page_state(&dataBuffer, 6) != MA_RESOURCE_MANAGER_PAGE_STATE_DECODED) {
+        printf("      The page after the read was not decoded ahead of time.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (test_decode_on_demand__get_page_state(&dataBuffer, 4) != MA_RESOURCE_MANAGER_PAGE_STATE_EMPTY || test_decode_on_demand__get_page_state(&dataBuffer, 7) != MA_RESOURCE_MANAGER_PAGE_STATE_EMPTY) {
+        printf("      Pages that were not needed were decoded.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* A read across the boundary into the next page shouldn't need to wait. */
+    cursor = (ma_uint64)pageSizeInFrames * 6 - ma_countof(samples)/2;
+
+    ma_resource_manager_data_buffer_seek_to_pcm_frame(&dataBuffer, cursor);
+    result = ma_resource_manager_data_buffer_read_pcm_frames(&dataBuffer, samples, ma_countof(samples), &framesRead);
+    if (result != MA_SUCCESS || framesRead != ma_countof(samples)) {
+        printf("      Reading across a page boundary returned %s with %u frames.\n", ma_result_description(result), (unsigned int)framesRead);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (resource_manager_check_ramp(samples, framesRead, cursor) == MA_FALSE) {
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    ma_resource_manager_data_buffer_uninit(&dataBuffer);
+    resource_manager_process_jobs(pResourceManager);
+
+    return result;
+}
+
+int test_entry__decode_on_demand(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_resource_manager resourceManager;
+
+    (void)argc;
+    (void)argv;
+
+    result = resource_manager_init(0, 0, &resourceManager);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return -1;
+    }
+
+    result = test_decode_on_demand__seek_into_undecoded_page(&resourceManager);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
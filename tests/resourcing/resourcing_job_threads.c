@@ -0,0 +1,357 @@
+#if defined(__linux__)
+#include <dirent.h>
+
+/* Finds the ID of the thread in this process with the given name. Returns 0 if there isn't one. */
+static unsigned long test_job_threads__find_thread(const char* pName)
+{
+    DIR* pDir;
+    struct dirent* pEntry;
+    unsigned long threadID = 0;
+
+    pDir = opendir("/proc/self/task");
+    if (pDir == NULL) {
+        return 0;
+    }
+
+    while ((pEntry = readdir(pDir)) != NULL) {
+        char path[512];
+        char comm[64];
+        FILE* pFile;
+
+        if (pEntry->d_name[0] == '.') {
+            continue;
+        }
+
+        sprintf(path, "/proc/self/task/%s/comm", pEntry->d_name);
+        pFile = fopen(path, "r");
+        if (pFile == NULL) {
+            continue;
+        }
+
+        comm[0] = '\0';
+        if (fgets(comm, sizeof(comm), pFile) != NULL) {
+            comm[strcspn(comm, "\n")] = '\0';
+        }
+        fclose(pFile);
+
+        if (strcmp(comm, pName) == 0) {
+            threadID = strtoul(pEntry->d_name, NULL, 10);
+            break;
+        }
+    }
+
+    closedir(pDir);
+    return threadID;
+}
+
+/* Copies the value of a "key: value" line from one of the files in /proc/self/task/<thread>/, such as status or sched. */
+static ma_bool32 test_job_threads__read_task_value(unsigned long threadID, const char* pFileName, const char* pKey, char* pValue, size_t valueCap)
+{
+    char path[256];
+    char line[256];
+    FILE* pFile;
+    ma_bool32 found = MA_FALSE;
+
+    sprintf(path, "/proc/self/task/%lu/%s", threadID, pFileName);
+    pFile = fopen(path, "r");
+    if (pFile == NULL) {
+        return MA_FALSE;
+    }
+
+    while (fgets(line, sizeof(line), pFile) != NULL) {
+        if (strncmp(line, pKey, strlen(pKey)) == 0) {
+            const char* pColon = strchr(line, ':');
+            if (pColon != NULL) {
+                pColon += 1;
+                pColon += strspn(pColon, " \t");
+                ma_strncpy_s(pValue, valueCap, pColon, (size_t)-1);
+                pValue[strcspn(pValue, "\n")] = '\0';
+                found = MA_TRUE;
+            }
+            break;
+        }
+    }
+
+    fclose(pFile);
+    return found;
+}
+#endif
+
+typedef struct
+{
+    ma_uint32 warningCount;
+} test_job_threads_log;
+
+static void test_job_threads_log_callback(void* pUserData, ma_uint32 level, const char* pMessage)
+{
+    (void)pMessage;
+
+    if (level == MA_LOG_LEVEL_WARNING) {
+        ((test_job_threads_log*)pUserData)->warningCount += 1;
+    }
+}
+
+/* Loads and checks the test file to make sure the job threads are working. */
+static ma_result test_job_threads__load(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_source dataSource;
+    float samples[4096];
+    ma_uint64 framesRead;
+
+    result = ma_resource_manager_data_source_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_DECODE | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_ASYNC | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_WAIT_INIT, NULL, &dataSource);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to load \"%s\". %s\n", RESOURCE_MANAGER_TEST_FILE_PATH, ma_result_description(result));
+        return result;
+    }
+
+    result = resource_manager_read_wait(&dataSource, samples, ma_countof(samples), &framesRead);
+    if (result == MA_SUCCESS && !resource_manager_check_ramp(samples, framesRead, 0)) {
+        result = MA_ERROR;
+    }
+
+    ma_resource_manager_data_source_uninit(&dataSource);
+
+    return result;
+}
+
+static ma_result test_job_threads__init(ma_resource_manager_config* pConfig, ma_log* pLog, ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+
+    pConfig->decodedFormat = ma_format_f32;
+    pConfig->pLog          = pLog;
+
+    result = ma_resource_manager_init(pConfig, pResourceManager);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    result = test_job_threads__load(pResourceManager);
+    if (result != MA_SUCCESS) {
+        ma_resource_manager_uninit(pResourceManager);
+    }
+
+    return result;
+}
+
+/*
+The job thread settings are applied by each thread to itself so the only way to check them is to look at the threads from the outside,
+which is only done on Linux. Everywhere else this just checks that the settings don't stop the resource manager from working. Settings
+that can't be applied, such as a negative nice value without privileges or a NUMA node that doesn't exist, must only post a warning.
+*/
+int test_entry__job_threads(int argc, char** argv)
+{
+    ma_result result;
+    ma_log log;
+    test_job_threads_log capture;
+    ma_resource_manager_config config;
+    ma_resource_manager resourceManager;
+    ma_uint32 cpus[1] = { 0 };  /* The only CPU we can rely on existing. */
+    ma_uint32 cpuList[8];
+    int exitCode = -1;
+
+    (void)argc;
+    (void)argv;
+
+    MA_ZERO_OBJECT(&capture);
+
+    result = ma_log_init(NULL, &log);
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    ma_log_register_callback(&log, ma_log_callback_init(test_job_threads_log_callback, &capture));
+
+    printf("    Defaults\n");
+    config = ma_resource_manager_config_init();
+    if (config.pJobThreadName != NULL || config.pJobThreadCPUs != NULL || config.jobThreadCPUCount != 0 || config.jobThreadNUMANode != -1 || config.jobThreadScheduling != ma_resource_manager_job_thread_scheduling_default || config.jobThreadNiceValue != 0) {
+        printf("      Unexpected default job thread settings.\n");
+        goto done;
+    }
+
+    printf("    CPU lists\n");
+    if (ma_resource_manager_parse_cpu_list("0-3,8,10-11\n", cpuList, ma_countof(cpuList)) != 7 || cpuList[3] != 3 || cpuList[4] != 8 || cpuList[6] != 11) {
+        printf("      Failed to parse \"0-3,8,10-11\".\n");
+        goto done;
+    }
+
+    if (ma_resource_manager_parse_cpu_list("0-63", cpuList, ma_countof(cpuList)) != 64 || cpuList[7] != 7) {
+        printf("      Failed to count \"0-63\" with a smaller output buffer.\n");
+        goto done;
+    }
+
+    printf("    Name, affinity and scheduling\n");
+    config = ma_resource_manager_config_init();
+    config.jobThreadCount      = 2;
+    config.pJobThreadName      = "ma_test_job";
+    config.pJobThreadCPUs      = cpus;
+    config.jobThreadCPUCount   = ma_countof(cpus);
+    config.jobThreadScheduling = ma_resource_manager_job_thread_scheduling_batch;
+    config.jobThreadNiceValue  = 5;
+
+    if (test_job_threads__init(&config, &log, &resourceManager) != MA_SUCCESS) {
+        goto done;
+    }
+
+#if defined(__linux__)
+    {
+        const char* pThreadNames[2] = { "ma_test_job0", "ma_test_job1" };
+        ma_uint32 iThread;
+
+        for (iThread = 0; iThread < ma_countof(pThreadNames); iThread += 1) {
+            unsigned long threadID = 0;
+            char value[64] = "";
+            ma_uint32 attempts;
+
+            /* The threads name themselves when they start so they might not have got to it yet. */
+            for (attempts = 0; attempts < 1000 && threadID == 0; attempts += 1) {
+                threadID = test_job_threads__find_thread(pThreadNames[iThread]);
+                if (threadID == 0) {
+                    ma_sleep(1);
+                }
+            }
+
+            if (threadID == 0) {
+                printf("      Could not find a thread named \"%s\".\n", pThreadNames[iThread]);
+                ma_resource_manager_uninit(&resourceManager);
+                goto done;
+            }
+
+            /* The name is set first, so wait for the rest of the settings with the same check as above. */
+            for (attempts = 0; attempts < 1000; attempts += 1) {
+                if (test_job_threads__read_task_value(threadID, "status", "Cpus_allowed_list", value, sizeof(value)) && strcmp(value, "0") == 0) {
+                    break;
+                }
+
+                ma_sleep(1);
+            }
+
+            if (attempts == 1000) {
+                printf("      \"%s\" is allowed to run on CPUs \"%s\". Expecting \"0\".\n", pThreadNames[iThread], value);
+                ma_resource_manager_uninit(&resourceManager);
+                goto done;
+            }
+
+            for (attempts = 0; attempts < 1000; attempts += 1) {
+                if (test_job_threads__read_task_value(threadID, "sched", "policy", value, sizeof(value)) && strcmp(value, "3") == 0) {    /* SCHED_BATCH */
+                    break;
+                }
+
+                ma_sleep(1);
+            }
+
+            if (attempts == 1000) {
+                printf("      \"%s\" has a scheduling policy of %s. Expecting SCHED_BATCH (3).\n", pThreadNames[iThread], value);
+                ma_resource_manager_uninit(&resourceManager);
+                goto done;
+            }
+
+            /* The priority of a normal thread is 120 plus its nice value. */
+            for (attempts = 0; attempts < 1000; attempts += 1) {
+                if (test_job_threads__read_task_value(threadID, "sched", "prio", value, sizeof(value)) && strcmp(value, "125") == 0) {
+                    break;
+                }
+
+                ma_sleep(1);
+            }
+
+            if (attempts == 1000) {
+                printf("      \"%s\" has a priority of %s. Expecting 125 for a nice value of 5.\n", pThreadNames[iThread], value);
+                ma_resource_manager_uninit(&resourceManager);
+                goto done;
+            }
+        }
+    }
+#endif
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (capture.warningCount != 0) {
+        printf("      %u warnings were posted for settings that should always work.\n", capture.warningCount);
+        goto done;
+    }
+
+    printf("    NUMA node\n");
+    config = ma_resource_manager_config_init();
+    config.jobThreadCount    = 1;
+    config.jobThreadNUMANode = 0;
+
+    if (test_job_threads__init(&config, &log, &resourceManager) != MA_SUCCESS) {
+        goto done;
+    }
+
+#if defined(__linux__)
+    {
+        /* When the node's CPU list can be read the threads are restricted to it. Otherwise a warning should have been posted instead. */
+        char* pNodeCPUList;
+        size_t nodeCPUListSize;
+
+        if (ma_vfs_open_and_read_file(NULL, "/sys/devices/system/node/node0/cpulist", (void**)&pNodeCPUList, &nodeCPUListSize, NULL) == MA_SUCCESS) {
+            char list[256];
+            ma_uint32 expectedCPUCount;
+
+            ma_strncpy_s(list, sizeof(list), pNodeCPUList, ma_min(nodeCPUListSize, sizeof(list) - 1));
+            ma_free(pNodeCPUList, NULL);
+
+            expectedCPUCount = ma_resource_manager_parse_cpu_list(list, NULL, 0);
+            if (resourceManager.config.jobThreadCPUCount != expectedCPUCount || resourceManager.config.pJobThreadCPUs == NULL) {
+                printf("      Expecting the job threads to be restricted to %u CPUs. Got %u.\n", expectedCPUCount, resourceManager.config.jobThreadCPUCount);
+                ma_resource_manager_uninit(&resourceManager);
+                goto done;
+            }
+        } else if (capture.warningCount == 0) {
+            printf("      The CPUs of NUMA node 0 could not be read but no warning was posted.\n");
+            ma_resource_manager_uninit(&resourceManager);
+            goto done;
+        }
+    }
+#endif
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    printf("    Fallbacks\n");
+    capture.warningCount = 0;
+
+    /* A node that doesn't exist can't restrict anything. */
+    config = ma_resource_manager_config_init();
+    config.jobThreadCount    = 1;
+    config.jobThreadNUMANode = 4095;
+
+    if (test_job_threads__init(&config, &log, &resourceManager) != MA_SUCCESS) {
+        goto done;
+    }
+
+    if (resourceManager.config.jobThreadCPUCount != 0) {
+        printf("      Job threads were restricted to %u CPUs of a NUMA node that doesn't exist.\n", resourceManager.config.jobThreadCPUCount);
+        ma_resource_manager_uninit(&resourceManager);
+        goto done;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+#if defined(__linux__)
+    if (capture.warningCount == 0) {
+        printf("      No warning was posted for a NUMA node that doesn't exist.\n");
+        goto done;
+    }
+#endif
+
+    /* Raising the priority needs privileges. Without them it should still work, just without the new nice value. */
+    config = ma_resource_manager_config_init();
+    config.jobThreadCount     = 1;
+    config.jobThreadNiceValue = -5;
+
+    if (test_job_threads__init(&config, &log, &resourceManager) != MA_SUCCESS) {
+        goto done;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    exitCode = 0;
+
+done:
+    ma_log_uninit(&log);
+    return exitCode;
+}
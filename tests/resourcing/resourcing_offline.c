@@ -0,0 +1,280 @@
+#define OFFLINE_TEST_FRAME_COUNT    (48000*2)
+
+/* Sleeps on every read so that the job threads fall behind the render and the offline reads have to wait for them. */
+typedef struct
+{
+    ma_vfs_callbacks cb;
+    ma_default_vfs defaultVFS;
+} offline_test_vfs;
+
+static ma_result offline_test_vfs__on_open(ma_vfs* pVFS, const char* pFilePath, ma_uint32 openMode, ma_vfs_file* pFile)
+{
+    return ma_vfs_open(&((offline_test_vfs*)pVFS)->defaultVFS, pFilePath, openMode, pFile);
+}
+
+static ma_result offline_test_vfs__on_open_w(ma_vfs* pVFS, const wchar_t* pFilePath, ma_uint32 openMode, ma_vfs_file* pFile)
+{
+    return ma_vfs_open_w(&((offline_test_vfs*)pVFS)->defaultVFS, pFilePath, openMode, pFile);
+}
+
+static ma_result offline_test_vfs__on_close(ma_vfs* pVFS, ma_vfs_file file)
+{
+    return ma_vfs_close(&((offline_test_vfs*)pVFS)->defaultVFS, file);
+}
+
+static ma_result offline_test_vfs__on_read(ma_vfs* pVFS, ma_vfs_file file, void* pDst, size_t sizeInBytes, size_t* pBytesRead)
+{
+    ma_sleep(1);
+    return ma_vfs_read(&((offline_test_vfs*)pVFS)->defaultVFS, file, pDst, sizeInBytes, pBytesRead);
+}
+
+static ma_result offline_test_vfs__on_write(ma_vfs* pVFS, ma_vfs_file file, const void* pSrc, size_t sizeInBytes, size_t* pBytesWritten)
+{
+    return ma_vfs_write(&((offline_test_vfs*)pVFS)->defaultVFS, file, pSrc, sizeInBytes, pBytesWritten);
+}
+
+static ma_result offline_test_vfs__on_seek(ma_vfs* pVFS, ma_vfs_file file, ma_int64 offset, ma_seek_origin origin)
+{
+    return ma_vfs_seek(&((offline_test_vfs*)pVFS)->defaultVFS, file, offset, origin);
+}
+
+static ma_result offline_test_vfs__on_tell(ma_vfs* pVFS, ma_vfs_file file, ma_int64* pCursor)
+{
+    return ma_vfs_tell(&((offline_test_vfs*)pVFS)->defaultVFS, file, pCursor);
+}
+
+static ma_result offline_test_vfs__on_info(ma_vfs* pVFS, ma_vfs_file file, ma_file_info* pInfo)
+{
+    return ma_vfs_info(&((offline_test_vfs*)pVFS)->defaultVFS, file, pInfo);
+}
+
+static void offline_test_vfs_init(offline_test_vfs* pVFS)
+{
+    MA_ZERO_OBJECT(pVFS);
+    pVFS->cb.onOpen  = offline_test_vfs__on_open;
+    pVFS->cb.onOpenW = offline_test_vfs__on_open_w;
+    pVFS->cb.onClose = offline_test_vfs__on_close;
+    pVFS->cb.onRead  = offline_test_vfs__on_read;
+    pVFS->cb.onWrite = offline_test_vfs__on_write;
+    pVFS->cb.onSeek  = offline_test_vfs__on_seek;
+    pVFS->cb.onTell  = offline_test_vfs__on_tell;
+    pVFS->cb.onInfo  = offline_test_vfs__on_info;
+
+    ma_default_vfs_init(&pVFS->defaultVFS, NULL);
+}
+
+/*
+Renders a decoded sound and a stream of the test file, both loaded asynchronously, to a WAV file. Offline rendering waits for the
+data instead of outputting silence so the output should be the same every time regardless of how long the jobs take. When
+pResourceManager is NULL the engine creates its own, which uses job threads, and pVFS is used for loading.
+*/
+ma_result test_offline__render(ma_resource_manager* pResourceManager, ma_vfs* pVFS, const char* pOutputFilePath)
+{
+    ma_result result;
+    ma_engine_config engineConfig;
+    ma_engine engine;
+    ma_encoder_config encoderConfig;
+    ma_encoder encoder;
+    ma_sound decodedSound;
+    ma_sound streamedSound;
+    ma_uint64 framesRendered;
+
+    engineConfig = ma_engine_config_init();
+    engineConfig.offline             = MA_TRUE;
+    engineConfig.channels            = 2;
+    engineConfig.sampleRate          = 48000;
+    engineConfig.pResourceManager    = pResourceManager;
+    engineConfig.pResourceManagerVFS = pVFS;
+
+    result = ma_engine_init(&engineConfig, &engine);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize engine. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    result = ma_sound_init_from_file(&engine, RESOURCE_MANAGER_TEST_FILE_PATH, MA_SOUND_FLAG_DECODE | MA_SOUND_FLAG_ASYNC | MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH, NULL, NULL, &decodedSound);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize decoded sound. %s\n", ma_result_description(result));
+        ma_engine_uninit(&engine);
+        return result;
+    }
+
+    result = ma_sound_init_from_file(&engine, RESOURCE_MANAGER_TEST_FILE_PATH, MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_ASYNC | MA_SOUND_FLAG_NO_SPATIALIZATION | MA_SOUND_FLAG_NO_PITCH, NULL, NULL, &streamedSound);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize streamed sound. %s\n", ma_result_description(result));
+        ma_sound_uninit(&decodedSound);
+        ma_engine_uninit(&engine);
+        return result;
+    }
+
+    ma_sound_start(&decodedSound);
+    ma_sound_start(&streamedSound);
+
+    encoderConfig = ma_encoder_config_init(ma_encoding_format_wav, ma_format_f32, 2, 48000);
+    result = ma_encoder_init_file(pOutputFilePath, &encoderConfig, &encoder);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to open \"%s\" for encoding. %s\n", pOutputFilePath, ma_result_description(result));
+        goto done;
+    }
+
+    result = ma_engine_render_to_encoder(&engine, &encoder, OFFLINE_TEST_FRAME_COUNT, &framesRendered);
+    ma_encoder_uninit(&encoder);
+
+    if (result != MA_SUCCESS || framesRendered != OFFLINE_TEST_FRAME_COUNT) {
+        printf("      Rendered %u frames. %s\n", (unsigned int)framesRendered, ma_result_description(result));
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    /* Without job threads the remaining jobs need to be run before the sounds can be uninitialized. */
+    if (pResourceManager != NULL) {
+        resource_manager_process_jobs(pResourceManager);
+    }
+
+    ma_sound_uninit(&streamedSound);
+    ma_sound_uninit(&decodedSound);
+
+    if (pResourceManager != NULL) {
+        resource_manager_process_jobs(pResourceManager);
+    }
+
+    ma_engine_uninit(&engine);
+
+    return result;
+}
+
+/* The sounds are mixed together so each frame should be twice its index. */
+ma_result test_offline__check_render(const char* pFilePath)
+{
+    ma_result result;
+    ma_decoder_config decoderConfig;
+    ma_decoder decoder;
+    float frames[1024 * 2];
+    ma_uint64 frameIndex = 0;
+
+    decoderConfig = ma_decoder_config_init(ma_format_f32, 2, 48000);
+
+    result = ma_decoder_init_file(pFilePath, &decoderConfig, &decoder);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to open \"%s\" for decoding. %s\n", pFilePath, ma_result_description(result));
+        return result;
+    }
+
+    while (frameIndex < OFFLINE_TEST_FRAME_COUNT) {
+        ma_uint64 framesRead;
+        ma_uint64 iFrame;
+
+        result = ma_decoder_read_pcm_frames(&decoder, frames, 1024, &framesRead);
+        if (result != MA_SUCCESS) {
+            break;
+        }
+
+        for (iFrame = 0; iFrame < framesRead; iFrame += 1) {
+            float expected = (float)((frameIndex + iFrame) * 2);
+
+            if (frames[iFrame*2 + 0] != expected || frames[iFrame*2 + 1] != expected) {
+                printf("      Frame %u of \"%s\" is %f. Expecting %f.\n", (unsigned int)(frameIndex + iFrame), pFilePath, frames[iFrame*2 + 0], expected);
+                ma_decoder_uninit(&decoder);
+                return MA_ERROR;
+            }
+        }
+
+        frameIndex += framesRead;
+    }
+
+    ma_decoder_uninit(&decoder);
+
+    if (frameIndex != OFFLINE_TEST_FRAME_COUNT) {
+        printf("      Expecting %u frames in \"%s\". Got %u.\n", (unsigned int)OFFLINE_TEST_FRAME_COUNT, pFilePath, (unsigned int)frameIndex);
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+ma_bool32 test_offline__files_equal(const char* pFilePathA, const char* pFilePathB)
+{
+    void* pDataA;
+    void* pDataB;
+    size_t sizeA;
+    size_t sizeB;
+    ma_bool32 isEqual;
+
+    if (ma_vfs_open_and_read_file(NULL, pFilePathA, &pDataA, &sizeA, NULL) != MA_SUCCESS) {
+        return MA_FALSE;
+    }
+
+    if (ma_vfs_open_and_read_file(NULL, pFilePathB, &pDataB, &sizeB, NULL) != MA_SUCCESS) {
+        ma_free(pDataA, NULL);
+        return MA_FALSE;
+    }
+
+    isEqual = sizeA == sizeB && memcmp(pDataA, pDataB, sizeA) == 0;
+
+    ma_free(pDataA, NULL);
+    ma_free(pDataB, NULL);
+
+    return isEqual;
+}
+
+int test_entry__offline(int argc, char** argv)
+{
+    ma_result result;
+    ma_resource_manager resourceManager;
+    offline_test_vfs vfs;
+    const char* pRenderPaths[3] =
+    {
+        TEST_OUTPUT_DIR"/offline_render_job_threads_1.wav",
+        TEST_OUTPUT_DIR"/offline_render_job_threads_2.wav",
+        TEST_OUTPUT_DIR"/offline_render_no_threading.wav"
+    };
+    ma_uint32 iRender;
+
+    (void)argc;
+    (void)argv;
+
+    /* Twice with the engine's own resource manager whose job threads the offline reads have to wait on. */
+    printf("    Job threads\n");
+    offline_test_vfs_init(&vfs);
+
+    for (iRender = 0; iRender < 2; iRender += 1) {
+        result = test_offline__render(NULL, &vfs, pRenderPaths[iRender]);
+        if (result != MA_SUCCESS) {
+            return -1;
+        }
+    }
+
+    /*
+    Once without threading so the offline reads have to run the jobs themselves. Sounds always wait for their data source to be
+    initialized which is only possible without job threads when threading is disabled.
+    */
+    printf("    No threading\n");
+    result = resource_manager_init(MA_RESOURCE_MANAGER_FLAG_OFFLINE | MA_RESOURCE_MANAGER_FLAG_NO_THREADING, 0, &resourceManager);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return -1;
+    }
+
+    result = test_offline__render(&resourceManager, NULL, pRenderPaths[2]);
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (result != MA_SUCCESS) {
+        return -1;
+    }
+
+    for (iRender = 0; iRender < ma_countof(pRenderPaths); iRender += 1) {
+        if (test_offline__check_render(pRenderPaths[iRender]) != MA_SUCCESS) {
+            return -1;
+        }
+    }
+
+    for (iRender = 1; iRender < ma_countof(pRenderPaths); iRender += 1) {
+        if (!test_offline__files_equal(pRenderPaths[0], pRenderPaths[iRender])) {
+            printf("    \"%s\" is not the same as \"%s\".\n", pRenderPaths[iRender], pRenderPaths[0]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,411 @@
+/* More pages than fit in the page index so that it has to be compacted. */
+#define PAGED_TEST_PAGE_COUNT   (MA_PAGED_AUDIO_BUFFER_PAGE_INDEX_SIZE * 3 + 5)
+
+typedef struct
+{
+    ma_uint32 mallocCount;
+    ma_uint32 freeCount;
+} paged_test_allocation_counter;
+
+static void* paged_test__malloc(size_t sz, void* pUserData)
+{
+    ((paged_test_allocation_counter*)pUserData)->mallocCount += 1;
+    return ma_malloc(sz, NULL);
+}
+
+static void* paged_test__realloc(void* p, size_t sz, void* pUserData)
+{
+    (void)pUserData;
+    return ma_realloc(p, sz, NULL);
+}
+
+static void paged_test__free(void* p, void* pUserData)
+{
+    if (p != NULL) {
+        ((paged_test_allocation_counter*)pUserData)->freeCount += 1;
+    }
+
+    ma_free(p, NULL);
+}
+
+static ma_allocation_callbacks paged_test_allocation_callbacks_init(paged_test_allocation_counter* pCounter)
+{
+    ma_allocation_callbacks callbacks;
+
+    MA_ZERO_OBJECT(pCounter);
+
+    callbacks.pUserData = pCounter;
+    callbacks.onMalloc  = paged_test__malloc;
+    callbacks.onRealloc = paged_test__realloc;
+    callbacks.onFree    = paged_test__free;
+
+    return callbacks;
+}
+
+/* Pages have different sizes so that page boundaries don't fall on a regular grid. */
+static ma_uint32 paged_test_get_page_size(ma_uint32 pageIndex)
+{
+    return 100 + (pageIndex % 7) * 13;
+}
+
+/* Appends pages to a mono f32 buffer where each sample is its frame index, the same as the resource manager test file. */
+static ma_result paged_test_append_pages(ma_paged_audio_buffer_data* pData, ma_uint32 firstPage, ma_uint32 pageCount, ma_uint64* pLength, const ma_allocation_callbacks* pAllocationCallbacks)
+{
+    float frames[256];
+    ma_uint32 iPage;
+
+    for (iPage = firstPage; iPage < firstPage + pageCount; iPage += 1) {
+        ma_uint32 pageSizeInFrames = paged_test_get_page_size(iPage);
+        ma_uint32 iFrame;
+        ma_result result;
+
+        MA_ASSERT(pageSizeInFrames <= ma_countof(frames));
+
+        for (iFrame = 0; iFrame < pageSizeInFrames; iFrame += 1) {
+            frames[iFrame] = (float)(*pLength + iFrame);
+        }
+
+        result = ma_paged_audio_buffer_data_allocate_and_append_page(pData, pageSizeInFrames, frames, pAllocationCallbacks);
+        if (result != MA_SUCCESS) {
+            printf("      Failed to append page %u. %s\n", (unsigned int)iPage, ma_result_description(result));
+            return result;
+        }
+
+        *pLength += pageSizeInFrames;
+    }
+
+    return MA_SUCCESS;
+}
+
+/* Seeks to the given frame and reads across at least one page boundary, checking the cursor and the data. */
+static ma_result paged_test_seek_and_check(ma_paged_audio_buffer* pBuffer, ma_uint64 frameIndex, ma_uint64 length)
+{
+    ma_result result;
+    float frames[300];
+    ma_uint64 framesRead;
+    ma_uint64 expectedFrameCount = ma_min(ma_countof(frames), length - frameIndex);
+    ma_uint64 cursor;
+    ma_uint64 iFrame;
+
+    result = ma_paged_audio_buffer_seek_to_pcm_frame(pBuffer, frameIndex);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to seek to frame %u. %s\n", (unsigned int)frameIndex, ma_result_description(result));
+        return result;
+    }
+
+    ma_paged_audio_buffer_get_cursor_in_pcm_frames(pBuffer, &cursor);
+    if (cursor != frameIndex) {
+        printf("      Expecting the cursor to be at %u after seeking. Got %u.\n", (unsigned int)frameIndex, (unsigned int)cursor);
+        return MA_ERROR;
+    }
+
+    ma_paged_audio_buffer_read_pcm_frames(pBuffer, frames, ma_countof(frames), &framesRead);
+    if (framesRead != expectedFrameCount) {
+        printf("      Expecting to read %u frames from %u. Got %u.\n", (unsigned int)expectedFrameCount, (unsigned int)frameIndex, (unsigned int)framesRead);
+        return MA_ERROR;
+    }
+
+    for (iFrame = 0; iFrame < framesRead; iFrame += 1) {
+        if (frames[iFrame] != (float)(frameIndex + iFrame)) {
+            printf("      Frame %u is %f after seeking to %u.\n", (unsigned int)(frameIndex + iFrame), frames[iFrame], (unsigned int)frameIndex);
+            return MA_ERROR;
+        }
+    }
+
+    return MA_SUCCESS;
+}
+
+/*
+Seeks forwards and backwards to the start and end of every page and to frames in between. Half of the pages are appended after the
+buffer has been read from so that the index has to be extended after it has been built.
+*/
+ma_result test_paged_audio_buffer__seek_across_pages(void)
+{
+    ma_result result;
+    ma_paged_audio_buffer_data data;
+    ma_paged_audio_buffer_config bufferConfig;
+    ma_paged_audio_buffer buffer;
+    ma_uint64 length = 0;
+    ma_uint64 pageFirstFrames[PAGED_TEST_PAGE_COUNT];
+    ma_uint32 batchPageCounts[2] = { PAGED_TEST_PAGE_COUNT / 2, PAGED_TEST_PAGE_COUNT };
+    ma_uint32 pageCount = 0;
+    ma_uint32 iBatch;
+    ma_uint32 iPage;
+    ma_lcg lcg;
+    ma_uint32 iSeek;
+
+    printf("    Seek across pages\n");
+
+    ma_paged_audio_buffer_data_init(ma_format_f32, 1, &data);
+
+    bufferConfig = ma_paged_audio_buffer_config_init(&data);
+    ma_paged_audio_buffer_init(&bufferConfig, &buffer);
+
+    for (iBatch = 0; iBatch < ma_countof(batchPageCounts); iBatch += 1) {
+        for (iPage = pageCount; iPage < batchPageCounts[iBatch]; iPage += 1) {
+            pageFirstFrames[iPage] = length;
+
+            result = paged_test_append_pages(&data, iPage, 1, &length, NULL);
+            if (result != MA_SUCCESS) {
+                goto done;
+            }
+        }
+
+        pageCount = batchPageCounts[iBatch];
+
+        /* Every page boundary from the end back to the start. */
+        for (iPage = pageCount; iPage > 0; iPage -= 1) {
+            result = paged_test_seek_and_check(&buffer, pageFirstFrames[iPage - 1] + paged_test_get_page_size(iPage - 1) - 1, length);
+            if (result != MA_SUCCESS) {
+                goto done;
+            }
+
+            result = paged_test_seek_and_check(&buffer, pageFirstFrames[iPage - 1], length);
+            if (result != MA_SUCCESS) {
+                goto done;
+            }
+        }
+
+        /* Then random positions in both directions. */
+        ma_lcg_seed(&lcg, 1234);
+        for (iSeek = 0; iSeek < 1000; iSeek += 1) {
+            result = paged_test_seek_and_check(&buffer, (ma_uint32)ma_lcg_rand_s32(&lcg) % length, length);
+            if (result != MA_SUCCESS) {
+                goto done;
+            }
+        }
+    }
+
+    result = MA_SUCCESS;
+
+done:
+    ma_paged_audio_buffer_uninit(&buffer);
+    ma_paged_audio_buffer_data_uninit(&data, NULL);
+
+    return result;
+}
+
+/* Seeking to exactly the end must work and leave the buffer at the end, but seeking any further must fail without moving the cursor. */
+ma_result test_paged_audio_buffer__seek_to_end(void)
+{
+    ma_result result;
+    ma_paged_audio_buffer_data data;
+    ma_paged_audio_buffer_config bufferConfig;
+    ma_paged_audio_buffer buffer;
+    ma_uint64 length = 0;
+    ma_uint64 cursor;
+    ma_uint64 framesRead;
+    float frames[16];
+
+    printf("    Seek to the end\n");
+
+    ma_paged_audio_buffer_data_init(ma_format_f32, 1, &data);
+
+    bufferConfig = ma_paged_audio_buffer_config_init(&data);
+    ma_paged_audio_buffer_init(&bufferConfig, &buffer);
+
+    result = paged_test_append_pages(&data, 0, 3, &length, NULL);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    result = ma_paged_audio_buffer_seek_to_pcm_frame(&buffer, length);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to seek to the end. %s\n", ma_result_description(result));
+        goto done;
+    }
+
+    ma_paged_audio_buffer_get_cursor_in_pcm_frames(&buffer, &cursor);
+    if (cursor != length) {
+        printf("      Expecting the cursor to be at %u after seeking to the end. Got %u.\n", (unsigned int)length, (unsigned int)cursor);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    result = ma_paged_audio_buffer_read_pcm_frames(&buffer, frames, ma_countof(frames), &framesRead);
+    if (result != MA_AT_END || framesRead != 0) {
+        printf("      Expecting MA_AT_END and no frames when reading at the end. Got %s and %u frames.\n", ma_result_description(result), (unsigned int)framesRead);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* Seek back to the middle first so the seek past the end starts from somewhere other than the end. */
+    result = ma_paged_audio_buffer_seek_to_pcm_frame(&buffer, length / 2);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    result = ma_paged_audio_buffer_seek_to_pcm_frame(&buffer, length + 1);
+    if (result != MA_BAD_SEEK) {
+        printf("      Expecting MA_BAD_SEEK when seeking past the end. Got %s.\n", ma_result_description(result));
+        result = MA_ERROR;
+        goto done;
+    }
+
+    ma_paged_audio_buffer_get_cursor_in_pcm_frames(&buffer, &cursor);
+    if (cursor != length / 2) {
+        printf("      The cursor moved to %u after a failed seek.\n", (unsigned int)cursor);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* A page appended while sitting at the end should be read from next. */
+    result = ma_paged_audio_buffer_seek_to_pcm_frame(&buffer, length);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    result = paged_test_append_pages(&data, 3, 1, &length, NULL);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    result = ma_paged_audio_buffer_read_pcm_frames(&buffer, frames, ma_countof(frames), &framesRead);
+    if (framesRead != ma_countof(frames) || frames[0] != (float)(length - paged_test_get_page_size(3))) {
+        printf("      Failed to read a page appended after seeking to the end.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    result = MA_SUCCESS;
+
+done:
+    ma_paged_audio_buffer_uninit(&buffer);
+    ma_paged_audio_buffer_data_uninit(&data, NULL);
+
+    return result;
+}
+
+/*
+Pages freed to a pool should be given back out by later allocations of a similar size instead of allocating new ones, but only up to the
+pool's maximum size. Pages that are too big for an allocation are left in the pool.
+*/
+ma_result test_paged_audio_buffer__pool_reuse(void)
+{
+    ma_result result;
+    paged_test_allocation_counter counter;
+    ma_allocation_callbacks allocationCallbacks;
+    ma_paged_audio_buffer_page_pool_config poolConfig;
+    ma_paged_audio_buffer_page_pool pool;
+    ma_paged_audio_buffer_data data;
+    ma_paged_audio_buffer_page* pPages[4];
+    ma_paged_audio_buffer_page* pPage;
+    ma_uint32 iPage;
+    ma_uint32 mallocCount;
+    size_t pageSizeInBytes = 1000 * sizeof(float);
+
+    printf("    Page pool reuse\n");
+
+    allocationCallbacks = paged_test_allocation_callbacks_init(&counter);
+
+    /* Room for three free pages. The fourth is freed straight away. */
+    poolConfig = ma_paged_audio_buffer_page_pool_config_init(pageSizeInBytes * 3);
+
+    result = ma_paged_audio_buffer_page_pool_init(&poolConfig, &allocationCallbacks, &pool);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize page pool. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    ma_paged_audio_buffer_data_init_ex(ma_format_f32, 1, &pool, &data);
+
+    for (iPage = 0; iPage < ma_countof(pPages); iPage += 1) {
+        result = ma_paged_audio_buffer_data_allocate_page(&data, 1000, NULL, NULL, &pPages[iPage]);
+        if (result != MA_SUCCESS) {
+            printf("      Failed to allocate page. %s\n", ma_result_description(result));
+            goto done;
+        }
+    }
+
+    for (iPage = 0; iPage < ma_countof(pPages); iPage += 1) {
+        ma_paged_audio_buffer_data_free_page(&data, pPages[iPage], NULL);
+    }
+
+    if (counter.mallocCount != 4 || counter.freeCount != 1 || pool.freeSizeInBytes != pageSizeInBytes * 3) {
+        printf("      Expecting 4 allocations, 1 free and 3 pages in the pool. Got %u allocations, %u frees and %u bytes in the pool.\n", (unsigned int)counter.mallocCount, (unsigned int)counter.freeCount, (unsigned int)pool.freeSizeInBytes);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* Slightly smaller pages should come out of the pool. They're the three pages that were freed first, most recently freed first. */
+    mallocCount = counter.mallocCount;
+    for (iPage = 0; iPage < 3; iPage += 1) {
+        result = ma_paged_audio_buffer_data_allocate_page(&data, 900, NULL, NULL, &pPage);
+        if (result != MA_SUCCESS) {
+            goto done;
+        }
+
+        if (pPage != pPages[2 - iPage]) {
+            printf("      Page %u was not reused from the pool.\n", (unsigned int)iPage);
+            ma_paged_audio_buffer_data_free_page(&data, pPage, NULL);
+            result = MA_ERROR;
+            goto done;
+        }
+
+        pPages[2 - iPage] = pPage;
+    }
+
+    if (counter.mallocCount != mallocCount || pool.freeSizeInBytes != 0) {
+        printf("      Reusing pages allocated %u times and left %u bytes in the pool.\n", (unsigned int)(counter.mallocCount - mallocCount), (unsigned int)pool.freeSizeInBytes);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    for (iPage = 0; iPage < 3; iPage += 1) {
+        ma_paged_audio_buffer_data_free_page(&data, pPages[iPage], NULL);
+    }
+
+    /* A page less than half the size of the free pages must not take one of them. */
+    result = ma_paged_audio_buffer_data_allocate_page(&data, 400, NULL, NULL, &pPage);
+    if (result != MA_SUCCESS) {
+        goto done;
+    }
+
+    ma_paged_audio_buffer_data_free_page(&data, pPage, NULL);
+
+    if (counter.mallocCount != mallocCount + 1 || pool.freeSizeInBytes != pageSizeInBytes * 3) {
+        printf("      A small page was taken from the pool.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    result = MA_SUCCESS;
+
+done:
+    ma_paged_audio_buffer_data_uninit(&data, NULL);
+    ma_paged_audio_buffer_page_pool_uninit(&pool);
+
+    /* Uninitializing the pool must free everything that was cached. */
+    if (result == MA_SUCCESS && counter.mallocCount != counter.freeCount) {
+        printf("      %u allocations but %u frees after uninitializing the pool.\n", (unsigned int)counter.mallocCount, (unsigned int)counter.freeCount);
+        result = MA_ERROR;
+    }
+
+    return result;
+}
+
+int test_entry__paged_audio_buffer(int argc, char** argv)
+{
+    ma_bool32 hasError = MA_FALSE;
+
+    (void)argc;
+    (void)argv;
+
+    if (test_paged_audio_buffer__seek_across_pages() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_paged_audio_buffer__seek_to_end() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_paged_audio_buffer__pool_reuse() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
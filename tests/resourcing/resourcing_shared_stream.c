@@ -0,0 +1,198 @@
+ma_result test_shared_stream__lockstep(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_stream streams[2];
+    float samples[2][1000];
+    ma_uint64 cursor;
+    ma_uint32 iStream;
+
+    printf("    Lockstep\n");
+
+    for (iStream = 0; iStream < ma_countof(streams); iStream += 1) {
+        result = ma_resource_manager_data_stream_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_SHARED_STREAM, NULL, &streams[iStream]);
+        if (result != MA_SUCCESS) {
+            printf("      Failed to initialize stream %u. %s\n", iStream, ma_result_description(result));
+            if (iStream > 0) {
+                ma_resource_manager_data_stream_uninit(&streams[0]);
+            }
+
+            return result;
+        }
+    }
+
+    /* Two streams at the same position must be reading from the same decoder. */
+    if (ma_atomic_load_ptr(&streams[0].pSharedStream) != ma_atomic_load_ptr(&streams[1].pSharedStream)) {
+        printf("      Streams at the same position are not shared.\n");
+        result = MA_ERROR;
+    }
+
+    for (cursor = 0; result == MA_SUCCESS && cursor < RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT; cursor += ma_countof(samples[0])) {
+        for (iStream = 0; iStream < ma_countof(streams); iStream += 1) {
+            ma_uint64 framesRead;
+
+            result = resource_manager_read_wait(&streams[iStream], samples[iStream], ma_countof(samples[iStream]), &framesRead);
+            if (result != MA_SUCCESS) {
+                printf("      Stream %u failed to read at frame %u. %s\n", iStream, (unsigned int)cursor, ma_result_description(result));
+                break;
+            }
+
+            if (resource_manager_check_ramp(samples[iStream], framesRead, cursor) == MA_FALSE) {
+                result = MA_ERROR;
+                break;
+            }
+        }
+    }
+
+    /* Seeking one of the streams far away should move it to a different shared stream without affecting the other one. */
+    if (result == MA_SUCCESS) {
+        ma_uint64 framesRead;
+
+        ma_resource_manager_data_stream_seek_to_pcm_frame(&streams[0], 0);
+        ma_resource_manager_data_stream_seek_to_pcm_frame(&streams[1], RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT / 2);
+
+        for (iStream = 0; iStream < ma_countof(streams); iStream += 1) {
+            result = resource_manager_read_wait(&streams[iStream], samples[iStream], ma_countof(samples[iStream]), &framesRead);
+            if (result != MA_SUCCESS || resource_manager_check_ramp(samples[iStream], framesRead, (iStream == 0) ? 0 : RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT / 2) == MA_FALSE) {
+                printf("      Stream %u returned incorrect data after seeking.\n", iStream);
+                result = MA_ERROR;
+                break;
+            }
+        }
+
+        if (result == MA_SUCCESS && ma_atomic_load_ptr(&streams[0].pSharedStream) == ma_atomic_load_ptr(&streams[1].pSharedStream)) {
+            printf("      Streams at different positions are sharing a decoder.\n");
+            result = MA_ERROR;
+        }
+    }
+
+    for (iStream = 0; iStream < ma_countof(streams); iStream += 1) {
+        ma_resource_manager_data_stream_uninit(&streams[iStream]);
+    }
+
+    return result;
+}
+
+
+typedef struct
+{
+    ma_resource_manager_data_stream* pDataStream;
+    MA_ATOMIC(4, ma_bool32) isStopRequested;
+    ma_bool32 hasError;
+    ma_uint64 readCount;
+} test_shared_stream_reader;
+
+static ma_thread_result MA_THREADCALL test_shared_stream__reader_thread(void* pUserData)
+{
+    test_shared_stream_reader* pReader = (test_shared_stream_reader*)pUserData;
+    float samples[480];
+
+    while (ma_atomic_load_32(&pReader->isStopRequested) == MA_FALSE) {
+        ma_uint64 framesRead = 0;
+        ma_uint64 iFrame;
+
+        ma_resource_manager_data_stream_read_pcm_frames(pReader->pDataStream, samples, ma_countof(samples), &framesRead);
+
+        /* A seek can happen at any time so we can only check that each read is contiguous and from within the file. */
+        for (iFrame = 0; iFrame < framesRead; iFrame += 1) {
+            if (samples[iFrame] != samples[0] + iFrame || samples[iFrame] < 0 || samples[iFrame] >= RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT) {
+                printf("      Read returned invalid data at frame %u: %f\n", (unsigned int)iFrame, samples[iFrame]);
+                pReader->hasError = MA_TRUE;
+                return (ma_thread_result)0;
+            }
+        }
+
+        if (framesRead > 0) {
+            pReader->readCount += 1;
+        }
+    }
+
+    return (ma_thread_result)0;
+}
+
+/*
+Seeking a stream that is the only consumer of its shared stream releases the shared stream on the job thread. This must never happen while the
+stream is being read from another thread.
+*/
+ma_result test_shared_stream__seek_while_reading(ma_resource_manager* pResourceManager)
+{
+    ma_result result;
+    ma_resource_manager_data_stream stream;
+    test_shared_stream_reader reader;
+    ma_thread thread;
+    ma_uint32 seed = 1;
+    ma_uint32 iSeek;
+
+    printf("    Seek while reading\n");
+
+    result = ma_resource_manager_data_stream_init(pResourceManager, RESOURCE_MANAGER_TEST_FILE_PATH, MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_STREAM | MA_RESOURCE_MANAGER_DATA_SOURCE_FLAG_SHARED_STREAM, NULL, &stream);
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize stream. %s\n", ma_result_description(result));
+        return result;
+    }
+
+    MA_ZERO_OBJECT(&reader);
+    reader.pDataStream = &stream;
+
+    result = ma_thread_create(&thread, ma_thread_priority_default, 0, test_shared_stream__reader_thread, &reader, NULL);
+    if (result != MA_SUCCESS) {
+        ma_resource_manager_data_stream_uninit(&stream);
+        return result;
+    }
+
+    /* The seeks are spaced out so we don't overflow the job queue. */
+    for (iSeek = 0; iSeek < 500 && reader.hasError == MA_FALSE; iSeek += 1) {
+        seed = (seed * 1103515245) + 12345;
+        ma_resource_manager_data_stream_seek_to_pcm_frame(&stream, (seed >> 8) % (RESOURCE_MANAGER_TEST_FILE_FRAME_COUNT - 48000));
+        ma_sleep(1);
+    }
+
+    ma_atomic_exchange_32(&reader.isStopRequested, MA_TRUE);
+    ma_thread_wait(&thread);
+
+    ma_resource_manager_data_stream_uninit(&stream);
+
+    if (reader.hasError) {
+        return MA_ERROR;
+    }
+
+    if (reader.readCount == 0) {
+        printf("      No data was read.\n");
+        return MA_ERROR;
+    }
+
+    return MA_SUCCESS;
+}
+
+int test_entry__shared_stream(int argc, char** argv)
+{
+    ma_result result;
+    ma_bool32 hasError = MA_FALSE;
+    ma_resource_manager resourceManager;
+
+    (void)argc;
+    (void)argv;
+
+    result = resource_manager_init(0, 1, &resourceManager);
+    if (result != MA_SUCCESS) {
+        printf("Failed to initialize resource manager. %s\n", ma_result_description(result));
+        return -1;
+    }
+
+    result = test_shared_stream__lockstep(&resourceManager);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    result = test_shared_stream__seek_while_reading(&resourceManager);
+    if (result != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    ma_resource_manager_uninit(&resourceManager);
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
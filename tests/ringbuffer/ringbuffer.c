@@ -0,0 +1,356 @@
+#define MA_NO_DEVICE_IO
+#include "../common/common.c"
+
+/* Fills a ring buffer region with a running counter so that reads can be checked against the order the frames were written in. */
+static void test_ring_buffer__fill(float* pFrames, ma_uint32 frameCount, float* pNextValue)
+{
+    ma_uint32 iFrame;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        pFrames[iFrame] = *pNextValue;
+        *pNextValue += 1;
+    }
+}
+
+static ma_bool32 test_ring_buffer__check(const float* pFrames, ma_uint32 frameCount, float* pNextValue)
+{
+    ma_uint32 iFrame;
+
+    for (iFrame = 0; iFrame < frameCount; iFrame += 1) {
+        if (pFrames[iFrame] != *pNextValue) {
+            printf("      Frame %u is %f. Expecting %f.\n", (unsigned int)iFrame, pFrames[iFrame], *pNextValue);
+            return MA_FALSE;
+        }
+
+        *pNextValue += 1;
+    }
+
+    return MA_TRUE;
+}
+
+/* A section that crosses the end of the buffer is split into two regions and committed in one go. */
+ma_result test_ring_buffer__regions(void)
+{
+    ma_result result;
+    ma_pcm_rb rb;
+    ma_pcm_rb_region regions[2];
+    ma_uint32 frameCount;
+    float nextWriteValue = 0;
+    float nextReadValue  = 0;
+    float* pFrames;
+
+    printf("    Regions\n");
+
+    result = ma_pcm_rb_init(ma_format_f32, 1, 64, NULL, NULL, &rb);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    /* Move both pointers to 48 frames in so the next 40 frames wrap. */
+    frameCount = 48;
+    ma_pcm_rb_acquire_write(&rb, &frameCount, (void**)&pFrames);
+    test_ring_buffer__fill(pFrames, frameCount, &nextWriteValue);
+    ma_pcm_rb_commit_write(&rb, frameCount);
+
+    frameCount = 48;
+    ma_pcm_rb_acquire_read(&rb, &frameCount, (void**)&pFrames);
+    test_ring_buffer__check(pFrames, frameCount, &nextReadValue);
+    ma_pcm_rb_commit_read(&rb, frameCount);
+
+    frameCount = 40;
+    ma_pcm_rb_acquire_write_regions(&rb, &frameCount, regions);
+    if (frameCount != 40 || regions[0].frameCount != 16 || regions[1].frameCount != 24 || regions[1].pFrames != ma_pcm_rb_get_subbuffer_ptr(&rb, 0, rb.rb.pBuffer)) {
+        printf("      Unexpected write regions: %u frames split into %u and %u.\n", (unsigned int)frameCount, (unsigned int)regions[0].frameCount, (unsigned int)regions[1].frameCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    test_ring_buffer__fill((float*)regions[0].pFrames, regions[0].frameCount, &nextWriteValue);
+    test_ring_buffer__fill((float*)regions[1].pFrames, regions[1].frameCount, &nextWriteValue);
+    ma_pcm_rb_commit_write_regions(&rb, frameCount);
+
+    /* Only 24 frames are free now so a bigger request is clamped, and committing more than is free must fail. */
+    frameCount = 100;
+    ma_pcm_rb_acquire_write_regions(&rb, &frameCount, regions);
+    if (frameCount != 24 || regions[0].frameCount + regions[1].frameCount != 24) {
+        printf("      Expecting the write to be clamped to 24 frames. Got %u.\n", (unsigned int)frameCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (ma_pcm_rb_commit_write_regions(&rb, 25) == MA_SUCCESS) {
+        printf("      Committing past the read pointer succeeded.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    frameCount = 64;
+    ma_pcm_rb_acquire_read_regions(&rb, &frameCount, regions);
+    if (frameCount != 40 || regions[0].frameCount != 16 || regions[1].frameCount != 24) {
+        printf("      Unexpected read regions: %u frames split into %u and %u.\n", (unsigned int)frameCount, (unsigned int)regions[0].frameCount, (unsigned int)regions[1].frameCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    if (!test_ring_buffer__check((const float*)regions[0].pFrames, regions[0].frameCount, &nextReadValue) ||
+        !test_ring_buffer__check((const float*)regions[1].pFrames, regions[1].frameCount, &nextReadValue)) {
+        result = MA_ERROR;
+        goto done;
+    }
+
+    ma_pcm_rb_commit_read_regions(&rb, frameCount);
+
+    if (ma_pcm_rb_available_read(&rb) != 0 || ma_pcm_rb_available_write(&rb) != 64) {
+        printf("      The buffer is not empty after reading everything back.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* Sections that don't cross the end leave the second region empty. */
+    frameCount = 8;
+    ma_pcm_rb_acquire_write_regions(&rb, &frameCount, regions);
+    if (frameCount != 8 || regions[0].frameCount != 8 || regions[1].frameCount != 0) {
+        printf("      Expecting a single region for a section that doesn't wrap.\n");
+        result = MA_ERROR;
+        goto done;
+    }
+
+done:
+    ma_pcm_rb_uninit(&rb);
+    return result;
+}
+
+/* With a mirrored buffer, acquiring past the end is never clamped and the data lands at the start of the buffer. */
+ma_result test_ring_buffer__mirrored(void)
+{
+    ma_result result;
+    ma_pcm_rb rb;
+    ma_uint32 sizeInFrames;
+    ma_uint32 frameCount;
+    float nextWriteValue = 0;
+    float nextReadValue  = 0;
+    float* pFrames;
+    float* pStart;
+
+    printf("    Mirrored\n");
+
+    result = ma_pcm_rb_init_mirrored(ma_format_f32, 2, 1000, NULL, &rb);
+    if (result == MA_NOT_IMPLEMENTED) {
+        printf("      Not supported on this platform. Skipping.\n");
+        return MA_SUCCESS;
+    }
+    if (result != MA_SUCCESS) {
+        printf("      Failed to initialize mirrored ring buffer. %s.\n", ma_result_description(result));
+        return result;
+    }
+
+    sizeInFrames = ma_pcm_rb_get_subbuffer_size(&rb);
+    if (sizeInFrames < 1000) {
+        printf("      The buffer is %u frames. Expecting at least 1000.\n", (unsigned int)sizeInFrames);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    /* Put both pointers 10 frames before the end. */
+    ma_pcm_rb_seek_write(&rb, sizeInFrames - 10);
+    ma_pcm_rb_seek_read(&rb,  sizeInFrames - 10);
+
+    frameCount = 30;
+    ma_pcm_rb_acquire_write(&rb, &frameCount, (void**)&pFrames);
+    if (frameCount != 30) {
+        printf("      Expecting 30 frames from a write that crosses the end. Got %u.\n", (unsigned int)frameCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    test_ring_buffer__fill(pFrames, frameCount * 2, &nextWriteValue);
+    ma_pcm_rb_commit_write(&rb, frameCount);
+
+    /* The 20 frames past the end must have gone to the start of the buffer. */
+    pStart = (float*)ma_pcm_rb_get_subbuffer_ptr(&rb, 0, rb.rb.pBuffer);
+    nextReadValue = 10 * 2;
+    if (!test_ring_buffer__check(pStart, 20 * 2, &nextReadValue)) {
+        result = MA_ERROR;
+        goto done;
+    }
+
+    nextReadValue = 0;
+    frameCount = 30;
+    ma_pcm_rb_acquire_read(&rb, &frameCount, (void**)&pFrames);
+    if (frameCount != 30 || !test_ring_buffer__check(pFrames, frameCount * 2, &nextReadValue)) {
+        printf("      Reading across the end of the buffer returned %u frames.\n", (unsigned int)frameCount);
+        result = MA_ERROR;
+        goto done;
+    }
+
+    ma_pcm_rb_commit_read(&rb, frameCount);
+
+done:
+    ma_pcm_rb_uninit(&rb);
+    return result;
+}
+
+
+#define TEST_RING_BUFFER_WAIT_FRAME_COUNT   48000
+#define TEST_RING_BUFFER_WAIT_CHUNK_SIZE    100
+
+static ma_thread_result MA_THREADCALL test_ring_buffer__producer(void* pUserData)
+{
+    ma_pcm_rb* pRB = (ma_pcm_rb*)pUserData;
+    float nextValue = 0;
+    ma_uint32 totalFramesWritten = 0;
+
+    while (totalFramesWritten < TEST_RING_BUFFER_WAIT_FRAME_COUNT) {
+        ma_uint32 frameCount = ma_min(TEST_RING_BUFFER_WAIT_CHUNK_SIZE, TEST_RING_BUFFER_WAIT_FRAME_COUNT - totalFramesWritten);
+        float* pFrames;
+
+        if (ma_pcm_rb_wait_write(pRB, frameCount) != MA_SUCCESS) {
+            break;
+        }
+
+        ma_pcm_rb_acquire_write(pRB, &frameCount, (void**)&pFrames);
+        test_ring_buffer__fill(pFrames, frameCount, &nextValue);
+        ma_pcm_rb_commit_write(pRB, frameCount);
+
+        totalFramesWritten += frameCount;
+    }
+
+    return (ma_thread_result)0;
+}
+
+typedef struct
+{
+    ma_pcm_rb* pRB;
+    ma_result result;
+} test_ring_buffer_waiter;
+
+static ma_thread_result MA_THREADCALL test_ring_buffer__waiter(void* pUserData)
+{
+    test_ring_buffer_waiter* pWaiter = (test_ring_buffer_waiter*)pUserData;
+
+    /* Nothing is ever written so this can only return when woken. */
+    pWaiter->result = ma_pcm_rb_wait_read(pWaiter->pRB, 1);
+
+    return (ma_thread_result)0;
+}
+
+/*
+The producer waits for space and the consumer waits for data. The buffer is much smaller than what's sent through it so both sides need to
+block many times. A waiter is then released with a wake.
+*/
+ma_result test_ring_buffer__wait(void)
+{
+    ma_result result;
+    ma_pcm_rb rb;
+    ma_thread thread;
+    test_ring_buffer_waiter waiter;
+    float nextValue = 0;
+    ma_uint32 totalFramesRead = 0;
+
+    printf("    Wait\n");
+
+    result = ma_pcm_rb_init(ma_format_f32, 1, 256, NULL, NULL, &rb);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    result = ma_thread_create(&thread, ma_thread_priority_default, 0, test_ring_buffer__producer, &rb, NULL);
+    if (result != MA_SUCCESS) {
+        ma_pcm_rb_uninit(&rb);
+        return result;
+    }
+
+    /* Reads are a different size to the writes so that the two sides don't move in lockstep. */
+    while (totalFramesRead < TEST_RING_BUFFER_WAIT_FRAME_COUNT) {
+        ma_uint32 frameCount = ma_min(70, TEST_RING_BUFFER_WAIT_FRAME_COUNT - totalFramesRead);
+        float* pFrames;
+
+        result = ma_pcm_rb_wait_read(&rb, frameCount);
+        if (result != MA_SUCCESS) {
+            printf("      Waiting for data failed. %s.\n", ma_result_description(result));
+            break;
+        }
+
+        ma_pcm_rb_acquire_read(&rb, &frameCount, (void**)&pFrames);
+        if (!test_ring_buffer__check(pFrames, frameCount, &nextValue)) {
+            result = MA_ERROR;
+            break;
+        }
+
+        ma_pcm_rb_commit_read(&rb, frameCount);
+        totalFramesRead += frameCount;
+    }
+
+    if (result != MA_SUCCESS) {
+        ma_pcm_rb_wake(&rb);    /* Get the producer out if it's waiting. */
+    }
+
+    ma_thread_wait(&thread);
+
+    if (result != MA_SUCCESS) {
+        ma_pcm_rb_uninit(&rb);
+        return result;
+    }
+
+    /* Waiting for more than the buffer can hold can never succeed. */
+    if (ma_pcm_rb_wait_read(&rb, 257) != MA_INVALID_ARGS) {
+        printf("      Waiting for more than the size of the buffer did not fail.\n");
+        ma_pcm_rb_uninit(&rb);
+        return MA_ERROR;
+    }
+
+    /* The buffer is empty now so this waiter stays blocked until it's woken. */
+    waiter.pRB    = &rb;
+    waiter.result = MA_BUSY;
+
+    result = ma_thread_create(&thread, ma_thread_priority_default, 0, test_ring_buffer__waiter, &waiter, NULL);
+    if (result != MA_SUCCESS) {
+        ma_pcm_rb_uninit(&rb);
+        return result;
+    }
+
+    ma_sleep(50);
+    ma_pcm_rb_wake(&rb);
+    ma_thread_wait(&thread);
+
+    if (waiter.result != MA_CANCELLED) {
+        printf("      Waking a waiter returned %s. Expecting MA_CANCELLED.\n", ma_result_description(waiter.result));
+        result = MA_ERROR;
+    }
+
+    ma_pcm_rb_uninit(&rb);
+    return result;
+}
+
+int test_entry__ring_buffer(int argc, char** argv)
+{
+    ma_bool32 hasError = MA_FALSE;
+
+    (void)argc;
+    (void)argv;
+
+    if (test_ring_buffer__regions() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_ring_buffer__mirrored() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (test_ring_buffer__wait() != MA_SUCCESS) {
+        hasError = MA_TRUE;
+    }
+
+    if (hasError) {
+        return -1;
+    } else {
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    ma_register_test("Ring Buffer", test_entry__ring_buffer);
+
+    return ma_run_tests(argc, argv);
+}
@@ -1,9 +1,12 @@
 /*
 USAGE: audioconverter [input file] [output file] [format] [channels] [rate]
+       audioconverter --batch [input directory or file list] [output directory] [format] [channels] [rate]
 
 EXAMPLES:
     audioconverter my_file.flac my_file.wav
     audioconverter my_file.flac my_file.wav f32 44100 linear --linear-order 8
+    audioconverter --batch sounds converted s16 48000 --output-type flac
+    audioconverter --batch file_list.txt converted --threads 4
 */
 #define _CRT_SECURE_NO_WARNINGS /* For stb_vorbis' usage of fopen() instead of fopen_s(). */
 
@@ -11,15 +14,29 @@ EXAMPLES:
 #include "../../extras/stb_vorbis.c"    /* Enables Vorbis decoding. */
 
 #define MA_NO_DEVICE_IO
-#define MA_NO_THREADING
 #define MINIAUDIO_IMPLEMENTATION
 #include "../../miniaudio.h"
 
 #include <stdio.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define INPUT_BUFFER_SIZE_IN_BYTES      (256 * 1024)
+#define OUTPUT_BUFFER_SIZE_IN_BYTES     (4 * 1024 * 1024)    /* Encoded data is written to disk in chunks of this size. */
+
 void print_usage()
 {
     printf("USAGE: audioconverter [input file] [output file] [format] [channels] [rate]\n");
+    printf("       audioconverter --batch [input directory or file list] [output directory] [format] [channels] [rate]\n");
     printf("  [format] is optional and can be one of the following:\n");
     printf("    u8  8-bit unsigned integer\n");
     printf("    s16 16-bit signed integer\n");
@@ -29,42 +46,16 @@ void print_usage()
     printf("  [channels] is optional and in the range of %d and %d\n", MA_MIN_CHANNELS, MA_MAX_CHANNELS);
     printf("  [rate] is optional and in the range of %d and %d\n", ma_standard_sample_rate_min, ma_standard_sample_rate_max);
     printf("\n");
+    printf("  In batch mode, a directory is searched recursively for files with a supported extension and the\n");
+    printf("  directory structure is mirrored in the output directory. Otherwise the input is a text file listing\n");
+    printf("  one input file per line. Relative paths in the list keep their directory in the output directory.\n");
+    printf("\n");
     printf("PARAMETERS:\n");
     printf("  --linear-order [0..%d]\n", MA_MAX_FILTER_ORDER);
-}
-
-ma_result do_conversion(ma_decoder* pDecoder, ma_encoder* pEncoder)
-{
-    ma_result result = MA_SUCCESS;
-
-    MA_ASSERT(pDecoder != NULL);
-    MA_ASSERT(pEncoder != NULL);
-
-    /*
-    All we do is read from the decoder and then write straight to the encoder. All of the necessary data conversion
-    will happen internally.
-    */
-    for (;;) {
-        ma_uint8 pRawData[MA_DATA_CONVERTER_STACK_BUFFER_SIZE];
-        ma_uint64 framesReadThisIteration;
-        ma_uint64 framesToReadThisIteration;
-
-        framesToReadThisIteration = sizeof(pRawData) / ma_get_bytes_per_frame(pDecoder->outputFormat, pDecoder->outputChannels);
-        result = ma_decoder_read_pcm_frames(pDecoder, pRawData, framesToReadThisIteration, &framesReadThisIteration);
-        if (result != MA_SUCCESS) {
-            break;  /* Reached the end, or an error occurred. */
-        }
-
-        /* At this point we have the raw data from the decoder. We now just need to write it to the encoder. */
-        ma_encoder_write_pcm_frames(pEncoder, pRawData, framesReadThisIteration, NULL);
-
-        /* Get out of the loop if we've reached the end. */
-        if (framesReadThisIteration < framesToReadThisIteration) {
-            break;
-        }
-    }
-
-    return result;
+    printf("  --output-type [wav|flac]  Defaults to wav in batch mode and to the output file's extension otherwise.\n");
+    printf("  --threads [count]         The number of files converted at once in batch mode, or the number of FLAC\n");
+    printf("                            encoding threads for a single file. Defaults to the number of CPU cores.\n");
+    printf("  --flac-level [0..8]       The FLAC compression level. Defaults to 5.\n");
 }
 
 ma_bool32 is_number(const char* str)
@@ -100,7 +91,7 @@ ma_bool32 try_parse_uint32_in_range(const char* str, ma_uint32* pValue, ma_uint3
     if (pValue != NULL) {
         *pValue = x;
     }
-    
+
     return MA_TRUE;
 }
 
@@ -156,129 +147,1209 @@ ma_bool32 try_parse_resample_algorithm(const char* str, ma_resample_algorithm* p
     return MA_TRUE;
 }
 
-int main(int argc, char** argv)
+ma_bool32 try_parse_encoding_format(const char* str, ma_encoding_format* pValue)
 {
-    ma_result result;
-    ma_decoder_config decoderConfig;
-    ma_decoder decoder;
-    ma_encoder_config encoderConfig;
-    ma_encoder encoder;
-    ma_encoding_format outputEncodingFormat;
-    ma_format format = ma_format_unknown;
-    ma_uint32 channels = 0;
-    ma_uint32 rate = 0;
-    ma_resample_algorithm resampleAlgorithm;
-    ma_uint32 linearOrder = 8;
-    int iarg;
-    const char* pOutputFilePath;
+    ma_encoding_format encodingFormat;
 
-    /* Print help if requested. */
-    if (argc == 2) {
-        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
-            print_usage();
-            return 0;
+    /*  */ if (strcmp(str, "wav") == 0) {
+        encodingFormat = ma_encoding_format_wav;
+    } else if (strcmp(str, "flac") == 0) {
+        encodingFormat = ma_encoding_format_flac;
+    } else {
+        return MA_FALSE;
+    }
+
+    if (pValue != NULL) {
+        *pValue = encodingFormat;
+    }
+
+    return MA_TRUE;
+}
+
+ma_bool32 is_supported_input_file(const char* pFilePath)
+{
+    return
+        ma_path_extension_equal(pFilePath, "wav")  ||
+        ma_path_extension_equal(pFilePath, "flac") ||
+        ma_path_extension_equal(pFilePath, "mp3")  ||
+        ma_path_extension_equal(pFilePath, "ogg");
+}
+
+ma_uint32 get_cpu_count()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (ma_uint32)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (ma_uint32)count : 1;
+#endif
+}
+
+
+
+/*
+Path helpers. Returned strings are allocated with ma_malloc() and need to be freed with ma_free().
+*/
+char* copy_string(const char* pString, size_t length)
+{
+    char* pCopy = (char*)ma_malloc(length + 1, NULL);
+    if (pCopy == NULL) {
+        return NULL;
+    }
+
+    MA_COPY_MEMORY(pCopy, pString, length);
+    pCopy[length] = '\0';
+
+    return pCopy;
+}
+
+char* join_path(const char* pBase, const char* pName)
+{
+    size_t baseLength = strlen(pBase);
+    size_t nameLength = strlen(pName);
+    char* pPath;
+
+    if (baseLength == 0) {
+        return copy_string(pName, nameLength);
+    }
+
+    /* Trailing slashes on the base are dropped so they don't double up. */
+    while (baseLength > 1 && (pBase[baseLength - 1] == '/' || pBase[baseLength - 1] == '\\')) {
+        baseLength -= 1;
+    }
+
+    pPath = (char*)ma_malloc(baseLength + 1 + nameLength + 1, NULL);
+    if (pPath == NULL) {
+        return NULL;
+    }
+
+    MA_COPY_MEMORY(pPath, pBase, baseLength);
+    if (pBase[baseLength - 1] != '/' && pBase[baseLength - 1] != '\\') {
+        pPath[baseLength] = '/';
+        baseLength += 1;
+    }
+    MA_COPY_MEMORY(pPath + baseLength, pName, nameLength + 1);
+
+    return pPath;
+}
+
+char* replace_extension(const char* pPath, const char* pExtension)
+{
+    const char* pOldExtension = ma_path_extension(pPath);
+    size_t stemLength;
+    char* pNewPath;
+
+    if (pOldExtension[0] == '\0') {
+        stemLength = strlen(pPath);
+    } else {
+        stemLength = (size_t)(pOldExtension - pPath) - 1;  /* -1 for the period. */
+    }
+
+    pNewPath = (char*)ma_malloc(stemLength + 1 + strlen(pExtension) + 1, NULL);
+    if (pNewPath == NULL) {
+        return NULL;
+    }
+
+    MA_COPY_MEMORY(pNewPath, pPath, stemLength);
+    pNewPath[stemLength] = '.';
+    strcpy(pNewPath + stemLength + 1, pExtension);
+
+    return pNewPath;
+}
+
+ma_bool32 is_directory(const char* pPath)
+{
+#if defined(_WIN32)
+    DWORD attributes = GetFileAttributesA(pPath);
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+    struct stat info;
+    return stat(pPath, &info) == 0 && S_ISDIR(info.st_mode);
+#endif
+}
+
+ma_result make_directory(const char* pPath)
+{
+#if defined(_WIN32)
+    if (!CreateDirectoryA(pPath, NULL) && GetLastError() != ERROR_ALREADY_EXISTS) {
+        return MA_ERROR;
+    }
+#else
+    if (mkdir(pPath, 0777) != 0 && errno != EEXIST) {
+        return ma_result_from_errno(errno);
+    }
+#endif
+
+    return MA_SUCCESS;
+}
+
+ma_result make_parent_directories(const char* pFilePath)
+{
+    ma_result result = MA_SUCCESS;
+    char* pPath;
+    size_t i;
+
+    pPath = copy_string(pFilePath, strlen(pFilePath));
+    if (pPath == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    /* Each parent is created in turn by temporarily terminating the string at each separator. Index 0 is skipped for absolute paths. */
+    for (i = 1; pPath[i] != '\0'; i += 1) {
+        if (pPath[i] == '/' || pPath[i] == '\\') {
+            char separator = pPath[i];
+
+            pPath[i] = '\0';
+            if (!is_directory(pPath)) {
+                result = make_directory(pPath);
+            }
+            pPath[i] = separator;
+
+            if (result != MA_SUCCESS) {
+                break;
+            }
         }
     }
 
-    if (argc < 3) {
-        print_usage();
-        return -1;
+    ma_free(pPath, NULL);
+    return result;
+}
+
+
+
+/*
+The list of files to convert.
+*/
+typedef struct
+{
+    char* pInputPath;
+    char* pOutputPath;
+} conversion_job;
+
+typedef struct
+{
+    conversion_job* pJobs;
+    ma_uint32 count;
+    ma_uint32 capacity;
+} conversion_job_list;
+
+void conversion_job_list_uninit(conversion_job_list* pList)
+{
+    ma_uint32 iJob;
+
+    for (iJob = 0; iJob < pList->count; iJob += 1) {
+        ma_free(pList->pJobs[iJob].pInputPath,  NULL);
+        ma_free(pList->pJobs[iJob].pOutputPath, NULL);
     }
 
-    resampleAlgorithm = ma_resample_algorithm_linear;
+    ma_free(pList->pJobs, NULL);
+}
 
-    /*
-    The fourth and fifth arguments can be a format and/or rate specifier. It doesn't matter which order they are in as we can identify them by whether or
-    not it's a number. If it's a number we assume it's a sample rate, otherwise we assume it's a format specifier.
-    */
-    for (iarg = 3; iarg < argc; iarg += 1) {
-        if (strcmp(argv[iarg], "--linear-order") == 0) {
-            iarg += 1;
-            if (iarg >= argc) {
+/* Takes ownership of both paths, even on failure. */
+ma_result conversion_job_list_add(conversion_job_list* pList, char* pInputPath, char* pOutputPath)
+{
+    if (pInputPath == NULL || pOutputPath == NULL) {
+        ma_free(pInputPath,  NULL);
+        ma_free(pOutputPath, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    if (pList->count == pList->capacity) {
+        ma_uint32 newCapacity = (pList->capacity == 0) ? 64 : pList->capacity * 2;
+        conversion_job* pNewJobs = (conversion_job*)ma_realloc(pList->pJobs, sizeof(*pNewJobs) * newCapacity, NULL);
+        if (pNewJobs == NULL) {
+            ma_free(pInputPath,  NULL);
+            ma_free(pOutputPath, NULL);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        pList->pJobs    = pNewJobs;
+        pList->capacity = newCapacity;
+    }
+
+    pList->pJobs[pList->count].pInputPath  = pInputPath;
+    pList->pJobs[pList->count].pOutputPath = pOutputPath;
+    pList->count += 1;
+
+    return MA_SUCCESS;
+}
+
+ma_result conversion_job_list_add_file(conversion_job_list* pList, const char* pInputPath, const char* pOutputDirectory, const char* pRelativePath, const char* pOutputExtension)
+{
+    char* pOutputPath;
+    char* pOutputPathWithExtension;
+
+    pOutputPath = join_path(pOutputDirectory, pRelativePath);
+    if (pOutputPath == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    pOutputPathWithExtension = replace_extension(pOutputPath, pOutputExtension);
+    ma_free(pOutputPath, NULL);
+
+    return conversion_job_list_add(pList, copy_string(pInputPath, strlen(pInputPath)), pOutputPathWithExtension);
+}
+
+ma_result conversion_job_list_add_directory(conversion_job_list* pList, const char* pInputDirectory, const char* pRelativeDirectory, const char* pOutputDirectory, const char* pOutputExtension)
+{
+    ma_result result = MA_SUCCESS;
+    char* pDirectory;
+
+    pDirectory = join_path(pInputDirectory, pRelativeDirectory);
+    if (pDirectory == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+#if defined(_WIN32)
+    {
+        WIN32_FIND_DATAA findData;
+        HANDLE hFind;
+        char* pPattern;
+
+        pPattern = join_path(pDirectory, "*");
+        if (pPattern == NULL) {
+            ma_free(pDirectory, NULL);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        hFind = FindFirstFileA(pPattern, &findData);
+        ma_free(pPattern, NULL);
+
+        if (hFind == INVALID_HANDLE_VALUE) {
+            ma_free(pDirectory, NULL);
+            return MA_DOES_NOT_EXIST;
+        }
+
+        do {
+            const char* pName = findData.cFileName;
+            char* pRelativePath;
+            char* pInputPath;
+
+            if (strcmp(pName, ".") == 0 || strcmp(pName, "..") == 0) {
+                continue;
+            }
+
+            pRelativePath = join_path(pRelativeDirectory, pName);
+            pInputPath    = join_path(pDirectory, pName);
+            if (pRelativePath == NULL || pInputPath == NULL) {
+                ma_free(pRelativePath, NULL);
+                ma_free(pInputPath, NULL);
+                result = MA_OUT_OF_MEMORY;
                 break;
             }
 
-            if (!try_parse_uint32_in_range(argv[iarg], &linearOrder, 0, 8)) {
-                printf("Expecting a number between 0 and %d for --linear-order.\n", MA_MAX_FILTER_ORDER);
-                return -1;
+            if ((findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0) {
+                result = conversion_job_list_add_directory(pList, pInputDirectory, pRelativePath, pOutputDirectory, pOutputExtension);
+            } else if (is_supported_input_file(pName)) {
+                result = conversion_job_list_add_file(pList, pInputPath, pOutputDirectory, pRelativePath, pOutputExtension);
             }
-            
-            continue;
+
+            ma_free(pRelativePath, NULL);
+            ma_free(pInputPath, NULL);
+        } while (result == MA_SUCCESS && FindNextFileA(hFind, &findData));
+
+        FindClose(hFind);
+    }
+#else
+    {
+        DIR* pDir;
+        struct dirent* pEntry;
+
+        pDir = opendir(pDirectory);
+        if (pDir == NULL) {
+            ma_free(pDirectory, NULL);
+            return ma_result_from_errno(errno);
         }
 
-        if (try_parse_resample_algorithm(argv[iarg], &resampleAlgorithm)) {
-            continue;
+        while (result == MA_SUCCESS && (pEntry = readdir(pDir)) != NULL) {
+            const char* pName = pEntry->d_name;
+            char* pRelativePath;
+            char* pInputPath;
+
+            if (strcmp(pName, ".") == 0 || strcmp(pName, "..") == 0) {
+                continue;
+            }
+
+            pRelativePath = join_path(pRelativeDirectory, pName);
+            pInputPath    = join_path(pDirectory, pName);
+            if (pRelativePath == NULL || pInputPath == NULL) {
+                ma_free(pRelativePath, NULL);
+                ma_free(pInputPath, NULL);
+                result = MA_OUT_OF_MEMORY;
+                break;
+            }
+
+            if (is_directory(pInputPath)) {
+                result = conversion_job_list_add_directory(pList, pInputDirectory, pRelativePath, pOutputDirectory, pOutputExtension);
+            } else if (is_supported_input_file(pName)) {
+                result = conversion_job_list_add_file(pList, pInputPath, pOutputDirectory, pRelativePath, pOutputExtension);
+            }
+
+            ma_free(pRelativePath, NULL);
+            ma_free(pInputPath, NULL);
         }
 
-        if (try_parse_format(argv[iarg], &format)) {
-            continue;
+        closedir(pDir);
+    }
+#endif
+
+    ma_free(pDirectory, NULL);
+    return result;
+}
+
+ma_result conversion_job_list_add_file_list(conversion_job_list* pList, const char* pListFilePath, const char* pOutputDirectory, const char* pOutputExtension)
+{
+    ma_result result;
+    FILE* pFile;
+    char line[4096];
+
+    result = ma_fopen(&pFile, pListFilePath, "rb");
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    while (fgets(line, sizeof(line), pFile) != NULL) {
+        size_t length = strlen(line);
+        const char* pRelativePath;
+
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' ')) {
+            length -= 1;
         }
+        line[length] = '\0';
 
-        if (try_parse_channels(argv[iarg], &channels)) {
+        if (length == 0) {
             continue;
         }
 
-        if (try_parse_sample_rate(argv[iarg], &rate)) {
-            continue;
+        /* Absolute paths go straight into the output directory. Relative paths keep their directory. */
+        pRelativePath = line;
+        if (line[0] == '/' || line[0] == '\\' || (length > 1 && line[1] == ':')) {
+            pRelativePath = ma_path_file_name(line);
+        }
+        while (pRelativePath[0] == '.' && (pRelativePath[1] == '/' || pRelativePath[1] == '\\')) {
+            pRelativePath += 2;
         }
 
-        /* Getting here means we have an unknown parameter. */
-        printf("Warning: Unknown parameter \"%s\"", argv[iarg]);
+        result = conversion_job_list_add_file(pList, line, pOutputDirectory, pRelativePath, pOutputExtension);
+        if (result != MA_SUCCESS) {
+            break;
+        }
     }
 
-    /* Initialize a decoder for the input file. */
-    decoderConfig = ma_decoder_config_init(format, channels, rate);
-    decoderConfig.resampling.algorithm = resampleAlgorithm;
-    decoderConfig.resampling.linear.lpfOrder = linearOrder;
+    fclose(pFile);
+    return result;
+}
 
-    result = ma_decoder_init_file(argv[1], &decoderConfig, &decoder);
-    if (result != MA_SUCCESS) {
-        printf("Failed to open input file. Check the file exists and the format is supported. Supported input formats:\n");
-    #if defined(ma_dr_opus_h)
-        printf("    Opus\n");
-    #endif
-    #if defined(ma_dr_mp3_h)
-        printf("    MP3\n");
-    #endif    
-    #if defined(ma_dr_flac_h)
-        printf("    FLAC\n");
-    #endif    
-    #if defined(STB_VORBIS_INCLUDE_STB_VORBIS_H)
-        printf("    Vorbis\n");
-    #endif
-    #if defined(ma_dr_wav_h)
-        printf("    WAV\n");
-    #endif
-        return (int)result;
+
+
+/*
+Input files are memory mapped where possible, and otherwise read into memory in one go. Either way the
+decoder is initialized from memory so there's no per-read file I/O.
+*/
+typedef struct
+{
+    void* pData;
+    size_t sizeInBytes;
+    ma_bool32 isMapped;
+#if defined(_WIN32)
+    HANDLE hFile;
+    HANDLE hMapping;
+#endif
+} input_file;
+
+ma_result input_file_open(input_file* pInputFile, const char* pFilePath)
+{
+    MA_ZERO_OBJECT(pInputFile);
+
+#if defined(_WIN32)
+    {
+        LARGE_INTEGER fileSize;
+
+        pInputFile->hFile = CreateFileA(pFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (pInputFile->hFile == INVALID_HANDLE_VALUE) {
+            return MA_DOES_NOT_EXIST;
+        }
+
+        if (!GetFileSizeEx(pInputFile->hFile, &fileSize) || fileSize.QuadPart == 0 || (ma_uint64)fileSize.QuadPart > MA_SIZE_MAX) {
+            CloseHandle(pInputFile->hFile);
+            return MA_INVALID_FILE;
+        }
+
+        pInputFile->sizeInBytes = (size_t)fileSize.QuadPart;
+
+        pInputFile->hMapping = CreateFileMappingA(pInputFile->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (pInputFile->hMapping != NULL) {
+            pInputFile->pData = MapViewOfFile(pInputFile->hMapping, FILE_MAP_READ, 0, 0, 0);
+            if (pInputFile->pData != NULL) {
+                pInputFile->isMapped = MA_TRUE;
+                return MA_SUCCESS;
+            }
+
+            CloseHandle(pInputFile->hMapping);
+        }
+
+        CloseHandle(pInputFile->hFile);
     }
+#else
+    {
+        struct stat info;
+        int fd;
+
+        fd = open(pFilePath, O_RDONLY);
+        if (fd < 0) {
+            return ma_result_from_errno(errno);
+        }
+
+        if (fstat(fd, &info) != 0 || info.st_size == 0 || (ma_uint64)info.st_size > MA_SIZE_MAX) {
+            close(fd);
+            return MA_INVALID_FILE;
+        }
 
+        pInputFile->sizeInBytes = (size_t)info.st_size;
 
-    pOutputFilePath = argv[2];
+        pInputFile->pData = mmap(NULL, pInputFile->sizeInBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  /* The mapping stays valid after the file is closed. */
 
-    outputEncodingFormat = ma_encoding_format_wav;  /* Wave by default in case we don't know the file extension. */
-    if (ma_path_extension_equal(pOutputFilePath, "wav")) {
-        outputEncodingFormat = ma_encoding_format_wav;
-    } else {
-        printf("Warning: Unknown file extension \"%s\". Encoding as WAV.\n", ma_path_extension(pOutputFilePath));
+        if (pInputFile->pData != MAP_FAILED) {
+        #if defined(MADV_SEQUENTIAL)
+            madvise(pInputFile->pData, pInputFile->sizeInBytes, MADV_SEQUENTIAL);
+        #endif
+            pInputFile->isMapped = MA_TRUE;
+            return MA_SUCCESS;
+        }
+
+        pInputFile->pData = NULL;
     }
+#endif
 
-    /* Initialize the encoder for the output file. */
-    encoderConfig = ma_encoder_config_init(outputEncodingFormat, decoder.outputFormat, decoder.outputChannels, decoder.outputSampleRate);
-    result = ma_encoder_init_file(pOutputFilePath, &encoderConfig, &encoder);
-    if (result != MA_SUCCESS) {
-        ma_decoder_uninit(&decoder);
-        printf("Failed to open output file. Check that the directory exists and that the file is not already opened by another process. %s", ma_result_description(result));
-        return -1;
+    /* Getting here means the file couldn't be mapped. Fall back to reading it into memory. */
+    {
+        ma_result result;
+        FILE* pFile;
+
+        result = ma_fopen(&pFile, pFilePath, "rb");
+        if (result != MA_SUCCESS) {
+            return result;
+        }
+
+        pInputFile->pData = ma_malloc(pInputFile->sizeInBytes, NULL);
+        if (pInputFile->pData == NULL) {
+            fclose(pFile);
+            return MA_OUT_OF_MEMORY;
+        }
+
+        if (fread(pInputFile->pData, 1, pInputFile->sizeInBytes, pFile) != pInputFile->sizeInBytes) {
+            ma_free(pInputFile->pData, NULL);
+            fclose(pFile);
+            return MA_IO_ERROR;
+        }
+
+        fclose(pFile);
     }
 
+    return MA_SUCCESS;
+}
 
-    /* We have our decoder and encoder ready, so now we can do the conversion. */
-    result = do_conversion(&decoder, &encoder);
-    
-    
-    /* Done. */
-    ma_encoder_uninit(&encoder);
-    ma_decoder_uninit(&decoder);
+void input_file_close(input_file* pInputFile)
+{
+    if (pInputFile->isMapped) {
+    #if defined(_WIN32)
+        UnmapViewOfFile(pInputFile->pData);
+        CloseHandle(pInputFile->hMapping);
+        CloseHandle(pInputFile->hFile);
+    #else
+        munmap(pInputFile->pData, pInputFile->sizeInBytes);
+    #endif
+    } else {
+        ma_free(pInputFile->pData, NULL);
+    }
+}
+
+
+
+/*
+Encoded output is collected in a large buffer and written out in big chunks. The buffer is flushed before
+seeking so encoders can go back and fill in their headers.
+*/
+typedef struct
+{
+    FILE* pFile;
+    ma_uint8* pBuffer;          /* OUTPUT_BUFFER_SIZE_IN_BYTES. Owned by the worker. */
+    size_t bufferedSizeInBytes;
+    ma_uint64 totalSizeInBytes;
+} output_file;
+
+ma_result output_file_flush(output_file* pOutputFile)
+{
+    if (pOutputFile->bufferedSizeInBytes > 0) {
+        if (fwrite(pOutputFile->pBuffer, 1, pOutputFile->bufferedSizeInBytes, pOutputFile->pFile) != pOutputFile->bufferedSizeInBytes) {
+            return MA_IO_ERROR;
+        }
+
+        pOutputFile->bufferedSizeInBytes = 0;
+    }
+
+    return MA_SUCCESS;
+}
+
+ma_result output_file_on_write(ma_encoder* pEncoder, const void* pData, size_t bytesToWrite, size_t* pBytesWritten)
+{
+    output_file* pOutputFile = (output_file*)pEncoder->pUserData;
+    ma_result result;
+
+    *pBytesWritten = 0;
+
+    if (pOutputFile->bufferedSizeInBytes + bytesToWrite > OUTPUT_BUFFER_SIZE_IN_BYTES) {
+        result = output_file_flush(pOutputFile);
+        if (result != MA_SUCCESS) {
+            return result;
+        }
+    }
+
+    if (bytesToWrite >= OUTPUT_BUFFER_SIZE_IN_BYTES) {
+        if (fwrite(pData, 1, bytesToWrite, pOutputFile->pFile) != bytesToWrite) {
+            return MA_IO_ERROR;
+        }
+    } else {
+        MA_COPY_MEMORY(pOutputFile->pBuffer + pOutputFile->bufferedSizeInBytes, pData, bytesToWrite);
+        pOutputFile->bufferedSizeInBytes += bytesToWrite;
+    }
+
+    pOutputFile->totalSizeInBytes += bytesToWrite;
+    *pBytesWritten = bytesToWrite;
+
+    return MA_SUCCESS;
+}
+
+ma_result output_file_on_seek(ma_encoder* pEncoder, ma_int64 offset, ma_seek_origin origin)
+{
+    output_file* pOutputFile = (output_file*)pEncoder->pUserData;
+    ma_result result;
+    int whence;
+
+    result = output_file_flush(pOutputFile);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    if (origin == ma_seek_origin_start) {
+        whence = SEEK_SET;
+    } else if (origin == ma_seek_origin_end) {
+        whence = SEEK_END;
+    } else {
+        whence = SEEK_CUR;
+    }
+
+    if (fseek(pOutputFile->pFile, (long)offset, whence) != 0) {
+        return MA_BAD_SEEK;
+    }
+
+    return MA_SUCCESS;
+}
+
+
+
+/*
+Each worker owns a decoder and encoder for the file it's working on, plus state that's kept from file to
+file. The data converter is only reinitialized when the input or output format changes, which for a
+typical sound library is almost never.
+*/
+typedef struct conversion_batch conversion_batch;
+
+typedef struct
+{
+    conversion_batch* pBatch;
+    ma_uint32 index;
+    ma_data_converter converter;
+    ma_data_converter_config converterConfig;
+    ma_channel converterChannelMapIn[MA_MAX_CHANNELS];
+    ma_bool32 hasConverter;
+    void* pInputBuffer;         /* INPUT_BUFFER_SIZE_IN_BYTES. Decoded data before conversion. */
+    void* pConvertedBuffer;     /* INPUT_BUFFER_SIZE_IN_BYTES. Converted data before encoding. */
+    void* pScratchBuffer;       /* INPUT_BUFFER_SIZE_IN_BYTES. Given to the data converter for its intermediary buffers. */
+    ma_uint8* pOutputBuffer;    /* OUTPUT_BUFFER_SIZE_IN_BYTES. */
+#ifndef MA_NO_THREADING
+    ma_thread thread;
+#endif
+} conversion_worker;
+
+struct conversion_batch
+{
+    conversion_job_list jobs;
+    MA_ATOMIC(4, ma_uint32) nextJob;
+    ma_format format;
+    ma_uint32 channels;
+    ma_uint32 sampleRate;
+    ma_resample_algorithm resampleAlgorithm;
+    ma_uint32 linearOrder;
+    ma_encoding_format encodingFormat;
+    ma_uint32 flacLevel;
+    ma_uint32 flacThreadCount;
+    ma_bool32 isQuiet;
+    ma_mutex lock;              /* For printing and the totals below. */
+    ma_uint32 succeededCount;
+    ma_uint32 failedCount;
+    ma_uint64 totalInputSizeInBytes;
+    ma_uint64 totalOutputSizeInBytes;
+    double totalDurationInSeconds;
+};
+
+ma_result conversion_worker_init(conversion_batch* pBatch, ma_uint32 index, conversion_worker* pWorker)
+{
+    MA_ZERO_OBJECT(pWorker);
+    pWorker->pBatch = pBatch;
+    pWorker->index  = index;
+
+    pWorker->pInputBuffer     = ma_malloc(INPUT_BUFFER_SIZE_IN_BYTES, NULL);
+    pWorker->pConvertedBuffer = ma_malloc(INPUT_BUFFER_SIZE_IN_BYTES, NULL);
+    pWorker->pScratchBuffer   = ma_malloc(INPUT_BUFFER_SIZE_IN_BYTES, NULL);
+    pWorker->pOutputBuffer    = (ma_uint8*)ma_malloc(OUTPUT_BUFFER_SIZE_IN_BYTES, NULL);
+
+    if (pWorker->pInputBuffer == NULL || pWorker->pConvertedBuffer == NULL || pWorker->pScratchBuffer == NULL || pWorker->pOutputBuffer == NULL) {
+        ma_free(pWorker->pInputBuffer,     NULL);
+        ma_free(pWorker->pConvertedBuffer, NULL);
+        ma_free(pWorker->pScratchBuffer,   NULL);
+        ma_free(pWorker->pOutputBuffer,    NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    return MA_SUCCESS;
+}
+
+void conversion_worker_uninit(conversion_worker* pWorker)
+{
+    if (pWorker->hasConverter) {
+        ma_data_converter_uninit(&pWorker->converter, NULL);
+    }
+
+    ma_free(pWorker->pInputBuffer,     NULL);
+    ma_free(pWorker->pConvertedBuffer, NULL);
+    ma_free(pWorker->pScratchBuffer,   NULL);
+    ma_free(pWorker->pOutputBuffer,    NULL);
+}
+
+ma_result conversion_worker_prepare_converter(conversion_worker* pWorker, const ma_data_converter_config* pConfig)
+{
+    ma_result result;
+    const ma_data_converter_config* pOld = &pWorker->converterConfig;
+
+    if (pWorker->hasConverter &&
+        pOld->formatIn      == pConfig->formatIn      && pOld->formatOut     == pConfig->formatOut     &&
+        pOld->channelsIn    == pConfig->channelsIn    && pOld->channelsOut   == pConfig->channelsOut   &&
+        pOld->sampleRateIn  == pConfig->sampleRateIn  && pOld->sampleRateOut == pConfig->sampleRateOut &&
+        memcmp(pWorker->converterChannelMapIn, pConfig->pChannelMapIn, sizeof(ma_channel) * pConfig->channelsIn) == 0) {
+        return ma_data_converter_reset(&pWorker->converter);
+    }
+
+    if (pWorker->hasConverter) {
+        ma_data_converter_uninit(&pWorker->converter, NULL);
+        pWorker->hasConverter = MA_FALSE;
+    }
+
+    result = ma_data_converter_init(pConfig, NULL, &pWorker->converter);
+    if (result != MA_SUCCESS) {
+        return result;
+    }
+
+    pWorker->converterConfig = *pConfig;
+    pWorker->converterConfig.pChannelMapIn = NULL;  /* Points to a local. The copy in converterChannelMapIn is used for comparisons. */
+    MA_COPY_MEMORY(pWorker->converterChannelMapIn, pConfig->pChannelMapIn, sizeof(ma_channel) * pConfig->channelsIn);
+    pWorker->hasConverter = MA_TRUE;
+
+    return MA_SUCCESS;
+}
+
+ma_result do_conversion(conversion_worker* pWorker, ma_decoder* pDecoder, ma_encoder* pEncoder, ma_uint64* pFramesConverted)
+{
+    ma_result result = MA_SUCCESS;
+    const ma_data_converter_config* pConfig = &pWorker->converterConfig;
+    ma_uint32 bytesPerFrameIn  = ma_get_bytes_per_frame(pConfig->formatIn,  pConfig->channelsIn);
+    ma_uint32 bytesPerFrameOut = ma_get_bytes_per_frame(pConfig->formatOut, pConfig->channelsOut);
+    ma_uint64 inputCapInFrames  = INPUT_BUFFER_SIZE_IN_BYTES / bytesPerFrameIn;
+    ma_uint64 outputCapInFrames = INPUT_BUFFER_SIZE_IN_BYTES / bytesPerFrameOut;
+
+    *pFramesConverted = 0;
+
+    /* Data is read from the decoder in its native format, run through the worker's converter, and then written to the encoder. */
+    for (;;) {
+        ma_uint64 framesRead;
+        ma_uint64 framesConsumed = 0;
+        ma_result readResult;
+
+        readResult = ma_decoder_read_pcm_frames(pDecoder, pWorker->pInputBuffer, inputCapInFrames, &framesRead);
+        if (readResult != MA_SUCCESS && readResult != MA_AT_END) {
+            result = readResult;
+            break;
+        }
+
+        while (framesConsumed < framesRead) {
+            ma_uint64 framesIn  = framesRead - framesConsumed;
+            ma_uint64 framesOut = outputCapInFrames;
+
+            result = ma_data_converter_process_pcm_frames(&pWorker->converter, ma_offset_ptr(pWorker->pInputBuffer, framesConsumed * bytesPerFrameIn), &framesIn, pWorker->pConvertedBuffer, &framesOut);
+            if (result != MA_SUCCESS) {
+                break;
+            }
+
+            if (framesOut > 0) {
+                ma_uint64 framesWritten;
+
+                result = ma_encoder_write_pcm_frames(pEncoder, pWorker->pConvertedBuffer, framesOut, &framesWritten);
+                if (result != MA_SUCCESS) {
+                    break;
+                }
+
+                *pFramesConverted += framesWritten;
+            }
+
+            if (framesIn == 0 && framesOut == 0) {
+                break;  /* Shouldn't happen, but don't loop forever if the converter gets stuck. */
+            }
+
+            framesConsumed += framesIn;
+        }
+
+        if (result != MA_SUCCESS || readResult == MA_AT_END || framesRead < inputCapInFrames) {
+            break;
+        }
+    }
+
+    return result;
+}
+
+void print_supported_input_formats()
+{
+    printf("Supported input formats:\n");
+#if defined(ma_dr_opus_h)
+    printf("    Opus\n");
+#endif
+#if defined(ma_dr_mp3_h)
+    printf("    MP3\n");
+#endif
+#if defined(ma_dr_flac_h)
+    printf("    FLAC\n");
+#endif
+#if defined(STB_VORBIS_INCLUDE_STB_VORBIS_H)
+    printf("    Vorbis\n");
+#endif
+#if defined(ma_dr_wav_h)
+    printf("    WAV\n");
+#endif
+}
+
+ma_result convert_file(conversion_worker* pWorker, const conversion_job* pJob)
+{
+    conversion_batch* pBatch = pWorker->pBatch;
+    ma_result result;
+    ma_timer timer;
+    input_file inputFile;
+    output_file outputFile;
+    ma_decoder_config decoderConfig;
+    ma_decoder decoder;
+    ma_data_converter_config converterConfig;
+    ma_channel channelMapIn[MA_MAX_CHANNELS];
+    ma_encoder_config encoderConfig;
+    ma_encoder encoder;
+    ma_uint64 framesConverted = 0;
+    double elapsedInSeconds;
+    double durationInSeconds;
+    const char* pErrorStage = NULL;
+
+    MA_ZERO_OBJECT(&inputFile);
+    MA_ZERO_OBJECT(&outputFile);
+    MA_ZERO_OBJECT(&converterConfig);
+
+    ma_timer_init(&timer);
+
+    result = input_file_open(&inputFile, pJob->pInputPath);
+    if (result != MA_SUCCESS) {
+        pErrorStage = "Failed to open input file";
+        goto done;
+    }
+
+    /*
+    The decoder outputs the requested sample format so backends that support it can decode straight to it, but the native channel count
+    and sample rate. Channel conversion and resampling is done by the worker's converter so it can be reused between files. FLAC output
+    is integer only, so in that case 32-bit is requested by default so integer sources don't go through floating point.
+    */
+    decoderConfig = ma_decoder_config_init(pBatch->format, 0, 0);
+    if (pBatch->format == ma_format_unknown && pBatch->encodingFormat == ma_encoding_format_flac) {
+        decoderConfig.format = ma_format_s32;
+    }
+
+    result = ma_decoder_init_memory(inputFile.pData, inputFile.sizeInBytes, &decoderConfig, &decoder);
+    if (result != MA_SUCCESS) {
+        input_file_close(&inputFile);
+        pErrorStage = "Failed to decode input file";
+        goto done;
+    }
+
+    converterConfig = ma_data_converter_config_init_default();
+    ma_decoder_get_data_format(&decoder, &converterConfig.formatIn, &converterConfig.channelsIn, &converterConfig.sampleRateIn, channelMapIn, ma_countof(channelMapIn));
+
+    converterConfig.formatOut     = (pBatch->format     != ma_format_unknown) ? pBatch->format     : converterConfig.formatIn;
+    converterConfig.channelsOut   = (pBatch->channels   != 0)                 ? pBatch->channels   : converterConfig.channelsIn;
+    converterConfig.sampleRateOut = (pBatch->sampleRate != 0)                 ? pBatch->sampleRate : converterConfig.sampleRateIn;
+    converterConfig.pChannelMapIn = channelMapIn;
+    converterConfig.resampling.algorithm       = pBatch->resampleAlgorithm;
+    converterConfig.resampling.linear.lpfOrder = pBatch->linearOrder;
+    converterConfig.pScratchBuffer           = pWorker->pScratchBuffer;
+    converterConfig.scratchBufferSizeInBytes = INPUT_BUFFER_SIZE_IN_BYTES;
+
+    /* FLAC supports up to 24-bit. */
+    if (pBatch->encodingFormat == ma_encoding_format_flac && (converterConfig.formatOut == ma_format_s32 || converterConfig.formatOut == ma_format_f32)) {
+        converterConfig.formatOut = ma_format_s24;
+    }
+
+    result = conversion_worker_prepare_converter(pWorker, &converterConfig);
+    if (result != MA_SUCCESS) {
+        ma_decoder_uninit(&decoder);
+        input_file_close(&inputFile);
+        pErrorStage = "Failed to initialize data converter";
+        goto done;
+    }
+
+    /* Initialize the encoder for the output file. */
+    result = make_parent_directories(pJob->pOutputPath);
+    if (result == MA_SUCCESS) {
+        outputFile.pBuffer = pWorker->pOutputBuffer;
+        result = ma_fopen(&outputFile.pFile, pJob->pOutputPath, "wb");
+    }
+
+    if (result != MA_SUCCESS) {
+        ma_decoder_uninit(&decoder);
+        input_file_close(&inputFile);
+        pErrorStage = "Failed to open output file. Check that the directory exists and that the file is not already opened by another process";
+        goto done;
+    }
+
+    encoderConfig = ma_encoder_config_init(pBatch->encodingFormat, converterConfig.formatOut, converterConfig.channelsOut, converterConfig.sampleRateOut);
+    encoderConfig.flac.compressionLevel = pBatch->flacLevel;
+    encoderConfig.flac.threadCount      = pBatch->flacThreadCount;
+
+    result = ma_encoder_init(output_file_on_write, output_file_on_seek, &outputFile, &encoderConfig, &encoder);
+    if (result != MA_SUCCESS) {
+        fclose(outputFile.pFile);
+        ma_decoder_uninit(&decoder);
+        input_file_close(&inputFile);
+        pErrorStage = "Failed to initialize encoder";
+        goto done;
+    }
+
+    /* We have our decoder and encoder ready, so now we can do the conversion. */
+    result = do_conversion(pWorker, &decoder, &encoder, &framesConverted);
+    if (result != MA_SUCCESS) {
+        pErrorStage = "Failed to convert";
+    }
+
+    ma_encoder_uninit(&encoder);
+    if (output_file_flush(&outputFile) != MA_SUCCESS && result == MA_SUCCESS) {
+        result = MA_IO_ERROR;
+        pErrorStage = "Failed to write output file";
+    }
+    fclose(outputFile.pFile);
+
+    ma_decoder_uninit(&decoder);
+    input_file_close(&inputFile);
+
+done:
+    elapsedInSeconds  = ma_timer_get_time_in_seconds(&timer);
+    durationInSeconds = (result == MA_SUCCESS) ? (double)framesConverted / converterConfig.sampleRateOut : 0;
+
+    ma_mutex_lock(&pBatch->lock);
+    {
+        if (result == MA_SUCCESS) {
+            pBatch->succeededCount         += 1;
+            pBatch->totalInputSizeInBytes  += inputFile.sizeInBytes;
+            pBatch->totalOutputSizeInBytes += outputFile.totalSizeInBytes;
+            pBatch->totalDurationInSeconds += durationInSeconds;
+
+            if (!pBatch->isQuiet) {
+                printf("[%u] %s -> %s: %.2fs of audio in %.3fs (%.1fx realtime, %.2f MB/s in, %.2f MB/s out)\n",
+                    pWorker->index, pJob->pInputPath, pJob->pOutputPath, durationInSeconds, elapsedInSeconds,
+                    durationInSeconds / ma_max(elapsedInSeconds, 1e-9),
+                    inputFile.sizeInBytes / (1024.0 * 1024.0) / ma_max(elapsedInSeconds, 1e-9),
+                    outputFile.totalSizeInBytes / (1024.0 * 1024.0) / ma_max(elapsedInSeconds, 1e-9));
+            }
+        } else {
+            pBatch->failedCount += 1;
+            printf("[%u] %s: %s. %s\n", pWorker->index, pJob->pInputPath, pErrorStage, ma_result_description(result));
+        }
+    }
+    ma_mutex_unlock(&pBatch->lock);
+
+    return result;
+}
+
+void conversion_worker_run(conversion_worker* pWorker)
+{
+    conversion_batch* pBatch = pWorker->pBatch;
+
+    /* Files are handed out one at a time so fast workers pick up the slack for slow ones. */
+    for (;;) {
+        ma_uint32 iJob = ma_atomic_fetch_add_32(&pBatch->nextJob, 1);
+        if (iJob >= pBatch->jobs.count) {
+            break;
+        }
+
+        convert_file(pWorker, &pBatch->jobs.pJobs[iJob]);
+    }
+}
+
+#ifndef MA_NO_THREADING
+static ma_thread_result MA_THREADCALL conversion_worker_thread(void* pUserData)
+{
+    conversion_worker_run((conversion_worker*)pUserData);
+    return (ma_thread_result)0;
+}
+#endif
+
+ma_result run_batch(conversion_batch* pBatch, ma_uint32 threadCount)
+{
+    ma_result result;
+    conversion_worker* pWorkers;
+    ma_uint32 workerCount;
+    ma_uint32 iWorker;
+    ma_timer timer;
+    double elapsedInSeconds;
+
+    workerCount = ma_clamp(threadCount, 1, ma_max(1, pBatch->jobs.count));
+#ifdef MA_NO_THREADING
+    workerCount = 1;
+#endif
+
+    pWorkers = (conversion_worker*)ma_malloc(sizeof(*pWorkers) * workerCount, NULL);
+    if (pWorkers == NULL) {
+        return MA_OUT_OF_MEMORY;
+    }
+
+    for (iWorker = 0; iWorker < workerCount; iWorker += 1) {
+        result = conversion_worker_init(pBatch, iWorker, &pWorkers[iWorker]);
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+
+    if (iWorker == 0) {
+        ma_free(pWorkers, NULL);
+        return MA_OUT_OF_MEMORY;
+    }
+
+    workerCount = iWorker;  /* Carry on with fewer workers if some couldn't be allocated. */
+
+    ma_timer_init(&timer);
+
+    /* The calling thread acts as the first worker. */
+#ifndef MA_NO_THREADING
+    for (iWorker = 1; iWorker < workerCount; iWorker += 1) {
+        result = ma_thread_create(&pWorkers[iWorker].thread, ma_thread_priority_normal, 0, conversion_worker_thread, &pWorkers[iWorker], NULL);
+        if (result != MA_SUCCESS) {
+            break;
+        }
+    }
+    threadCount = iWorker;
+#endif
+
+    conversion_worker_run(&pWorkers[0]);
+
+#ifndef MA_NO_THREADING
+    for (iWorker = 1; iWorker < threadCount; iWorker += 1) {
+        ma_thread_wait(&pWorkers[iWorker].thread);
+    }
+#endif
+
+    elapsedInSeconds = ma_timer_get_time_in_seconds(&timer);
+
+    for (iWorker = 0; iWorker < workerCount; iWorker += 1) {
+        conversion_worker_uninit(&pWorkers[iWorker]);
+    }
+    ma_free(pWorkers, NULL);
+
+    if (pBatch->jobs.count > 1) {
+        printf("\n");
+        printf("Converted %u of %u files in %.3fs on %u %s.\n", pBatch->succeededCount, pBatch->jobs.count, elapsedInSeconds, workerCount, (workerCount == 1) ? "thread" : "threads");
+        printf("  %.2fs of audio (%.1fx realtime)\n", pBatch->totalDurationInSeconds, pBatch->totalDurationInSeconds / ma_max(elapsedInSeconds, 1e-9));
+        printf("  %.2f MB in (%.2f MB/s), %.2f MB out (%.2f MB/s)\n",
+            pBatch->totalInputSizeInBytes  / (1024.0 * 1024.0), pBatch->totalInputSizeInBytes  / (1024.0 * 1024.0) / ma_max(elapsedInSeconds, 1e-9),
+            pBatch->totalOutputSizeInBytes / (1024.0 * 1024.0), pBatch->totalOutputSizeInBytes / (1024.0 * 1024.0) / ma_max(elapsedInSeconds, 1e-9));
+    }
+
+    return (pBatch->failedCount == 0) ? MA_SUCCESS : MA_ERROR;
+}
+
+int main(int argc, char** argv)
+{
+    ma_result result;
+    conversion_batch batch;
+    ma_bool32 isBatch = MA_FALSE;
+    ma_bool32 hasOutputType = MA_FALSE;
+    ma_uint32 threadCount = 0;
+    int iarg;
+    int firstArg;
+    const char* pInputPath;
+    const char* pOutputPath;
+
+    /* Print help if requested. */
+    if (argc == 2) {
+        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+            print_usage();
+            return 0;
+        }
+    }
+
+    firstArg = 1;
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0) {
+        isBatch  = MA_TRUE;
+        firstArg = 2;
+    }
+
+    if (argc < firstArg + 2) {
+        print_usage();
+        return -1;
+    }
+
+    pInputPath  = argv[firstArg + 0];
+    pOutputPath = argv[firstArg + 1];
+
+    MA_ZERO_OBJECT(&batch);
+    batch.format            = ma_format_unknown;
+    batch.resampleAlgorithm = ma_resample_algorithm_linear;
+    batch.linearOrder       = 8;
+    batch.encodingFormat    = ma_encoding_format_wav;
+    batch.flacLevel         = 5;
+
+    /*
+    The remaining arguments can be a format, channel count and/or rate specifier. It doesn't matter which order they are in as we can identify them by
+    whether or not it's a number. If it's a number we assume it's a channel count or sample rate, otherwise we assume it's a format specifier.
+    */
+    for (iarg = firstArg + 2; iarg < argc; iarg += 1) {
+        if (strcmp(argv[iarg], "--linear-order") == 0) {
+            iarg += 1;
+            if (iarg >= argc) {
+                break;
+            }
+
+            if (!try_parse_uint32_in_range(argv[iarg], &batch.linearOrder, 0, 8)) {
+                printf("Expecting a number between 0 and %d for --linear-order.\n", MA_MAX_FILTER_ORDER);
+                return -1;
+            }
+
+            continue;
+        }
+
+        if (strcmp(argv[iarg], "--output-type") == 0) {
+            iarg += 1;
+            if (iarg >= argc || !try_parse_encoding_format(argv[iarg], &batch.encodingFormat)) {
+                printf("Expecting wav or flac for --output-type.\n");
+                return -1;
+            }
+
+            hasOutputType = MA_TRUE;
+            continue;
+        }
+
+        if (strcmp(argv[iarg], "--threads") == 0) {
+            iarg += 1;
+            if (iarg >= argc || !try_parse_uint32_in_range(argv[iarg], &threadCount, 1, 1024)) {
+                printf("Expecting a number between 1 and 1024 for --threads.\n");
+                return -1;
+            }
+
+            continue;
+        }
+
+        if (strcmp(argv[iarg], "--flac-level") == 0) {
+            iarg += 1;
+            if (iarg >= argc || !try_parse_uint32_in_range(argv[iarg], &batch.flacLevel, 0, 8)) {
+                printf("Expecting a number between 0 and 8 for --flac-level.\n");
+                return -1;
+            }
+
+            continue;
+        }
+
+        if (try_parse_resample_algorithm(argv[iarg], &batch.resampleAlgorithm)) {
+            continue;
+        }
+
+        if (try_parse_format(argv[iarg], &batch.format)) {
+            continue;
+        }
+
+        if (try_parse_channels(argv[iarg], &batch.channels)) {
+            continue;
+        }
+
+        if (try_parse_sample_rate(argv[iarg], &batch.sampleRate)) {
+            continue;
+        }
+
+        /* Getting here means we have an unknown parameter. */
+        printf("Warning: Unknown parameter \"%s\"\n", argv[iarg]);
+    }
+
+    if (threadCount == 0) {
+        threadCount = get_cpu_count();
+    }
+
+    if (isBatch) {
+        const char* pOutputExtension = (batch.encodingFormat == ma_encoding_format_flac) ? "flac" : "wav";
+
+        if (is_directory(pInputPath)) {
+            result = conversion_job_list_add_directory(&batch.jobs, pInputPath, "", pOutputPath, pOutputExtension);
+        } else {
+            result = conversion_job_list_add_file_list(&batch.jobs, pInputPath, pOutputPath, pOutputExtension);
+        }
+
+        if (result != MA_SUCCESS) {
+            printf("Failed to read \"%s\". %s\n", pInputPath, ma_result_description(result));
+            conversion_job_list_uninit(&batch.jobs);
+            return (int)result;
+        }
+
+        if (batch.jobs.count == 0) {
+            printf("No files to convert.\n");
+            print_supported_input_formats();
+            conversion_job_list_uninit(&batch.jobs);
+            return 0;
+        }
+    } else {
+        /* A single file is converted on the calling thread. With FLAC, the encoder itself can use the other threads. */
+        if (!hasOutputType) {
+            if (ma_path_extension_equal(pOutputPath, "wav")) {
+                batch.encodingFormat = ma_encoding_format_wav;
+            } else if (ma_path_extension_equal(pOutputPath, "flac")) {
+                batch.encodingFormat = ma_encoding_format_flac;
+            } else {
+                printf("Warning: Unknown file extension \"%s\". Encoding as WAV.\n", ma_path_extension(pOutputPath));  /* Wave by default in case we don't know the file extension. */
+            }
+        }
+
+        batch.flacThreadCount = threadCount;
+        threadCount = 1;
+
+        result = conversion_job_list_add(&batch.jobs, copy_string(pInputPath, strlen(pInputPath)), copy_string(pOutputPath, strlen(pOutputPath)));
+        if (result != MA_SUCCESS) {
+            return (int)result;
+        }
+    }
+
+    result = ma_mutex_init(&batch.lock);
+    if (result != MA_SUCCESS) {
+        conversion_job_list_uninit(&batch.jobs);
+        return (int)result;
+    }
+
+    result = run_batch(&batch, threadCount);
+
+    if (!isBatch && result != MA_SUCCESS) {
+        print_supported_input_formats();
+    }
+
+    ma_mutex_uninit(&batch.lock);
+    conversion_job_list_uninit(&batch.jobs);
 
     return (int)result;
 }